@@ -60,26 +60,53 @@ namespace boost {
 class fdoutbuf : public std::streambuf {
   protected:
     int fd;    // file descriptor
+    /* data buffer:
+     * - output is gathered here and handed to fd in large blocks,
+     *   rather than with one write per character or string, so that
+     *   whatever reads the other end (such as a pager) is kept busy
+     *   while more output is being produced
+     */
+    static const int bufSize = 8192;    // size of the data buffer
+    char buffer[bufSize];               // data buffer
   public:
     // constructor
     fdoutbuf (int _fd) : fd(_fd) {
+	setp (buffer, buffer+bufSize);
+    }
+    // destructor: write out whatever is still buffered
+    virtual ~fdoutbuf () {
+	flushBuffer();
     }
   protected:
-    // write one character
-    virtual int_type overflow (int_type c) {
-	if (c != EOF) {
-	    char z = static_cast<char>(c);
-	    if (write (fd, &z, 1) != 1) {
+    // write the buffered characters, coping with partial writes
+    int flushBuffer () {
+	const char* p = pbase();
+	std::streamsize num = pptr()-pbase();
+	while (num > 0) {
+	    ssize_t written = write (fd, p, num);
+	    if (written <= 0) {
 		return EOF;
 	    }
+	    p += written;
+	    num -= written;
+	}
+	setp (buffer, buffer+bufSize);
+	return 0;
+    }
+    // buffer full: write it out, then store one more character
+    virtual int_type overflow (int_type c) {
+	if (flushBuffer() == EOF) {
+	    return EOF;
+	}
+	if (c != EOF) {
+	    *pptr() = static_cast<char>(c);
+	    pbump(1);
 	}
-	return c;
+	return traits_type::not_eof(c);
     }
-    // write multiple characters
-    virtual
-    std::streamsize xsputn (const char* s,
-			    std::streamsize num) {
-	return write(fd,s,num);
+    // synchronize data with the file descriptor
+    virtual int sync () {
+	return flushBuffer() == EOF ? -1 : 0;
     }
 };
 
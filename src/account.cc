@@ -38,6 +38,8 @@
 
 namespace ledger {
 
+std::size_t account_t::xdata_generation = 0;
+
 account_t::~account_t()
 {
   TRACE_DTOR(account_t);
@@ -46,6 +48,27 @@ account_t::~account_t()
     checked_delete(pair.second);
 }
 
+bool account_t::remove_post(post_t * post)
+{
+  // The posting is most often the one added last, so search backwards.
+  posts_deque::reverse_iterator i = std::find(posts.rbegin(), posts.rend(),
+					      post);
+  if (i == posts.rend())
+    return false;
+
+  posts_deque::iterator j = --i.base();
+  std::size_t		position = j - posts.begin();
+  posts.erase(j);
+
+  // Keep self_total's count of postings already summed in step, and
+  // drop the date index, whose staleness check only compares sizes.
+  if (has_xdata() && xdata_->self_details.last_size > position)
+    --xdata_->self_details.last_size;
+  date_index_ = none;
+
+  return true;
+}
+
 account_t * account_t::find_account(const string& name,
 				    const bool	  auto_create)
 {
@@ -361,8 +384,7 @@ account_t::xdata_t::details_t::operator+=(const details_t& other)
 
 value_t account_t::self_total(const optional<expr_t&>& expr) const
 {
-  if (xdata_ && xdata_->has_flags(ACCOUNT_EXT_VISITED)) {
-    if (! xdata_) xdata_ = xdata_t();
+  if (has_xdata() && xdata_->has_flags(ACCOUNT_EXT_VISITED)) {
 
     posts_deque::const_iterator i =
       posts.begin() + xdata_->self_details.last_size;
@@ -383,9 +405,106 @@ value_t account_t::self_total(const optional<expr_t&>& expr) const
   }
 }
 
+namespace {
+  bool post_date_is_earlier(const post_t * left, const post_t * right)
+  {
+    return left->date() < right->date();
+  }
+}
+
+bool account_t::has_date_index() const
+{
+  return (date_index_ && date_index_->last_size == posts.size() &&
+	  date_index_->effective == item_t::use_effective_date);
+}
+
+const account_t::date_index_t& account_t::date_index() const
+{
+  if (has_date_index())
+    return *date_index_;
+
+  std::vector<post_t *> sorted;
+  sorted.reserve(posts.size());
+  foreach (post_t * post, posts)
+    if (! post->amount.is_null())
+      sorted.push_back(post);
+
+  std::stable_sort(sorted.begin(), sorted.end(), post_date_is_earlier);
+
+  date_index_ = date_index_t();
+  date_index_->dates.reserve(sorted.size());
+
+  foreach (post_t * post, sorted) {
+    date_index_t::series_t& series
+      (date_index_->series[&post->amount.commodity()]);
+
+    series.positions.push_back(date_index_->dates.size());
+    if (series.totals.empty())
+      series.totals.push_back(post->amount);
+    else
+      series.totals.push_back(series.totals.back() + post->amount);
+
+    date_index_->dates.push_back(post->date());
+  }
+
+  date_index_->last_size = posts.size();
+  date_index_->effective = item_t::use_effective_date;
+
+  DEBUG("account.date_index",
+	"Indexed " << sorted.size() << " postings of " << fullname());
+
+  return *date_index_;
+}
+
+value_t account_t::self_total(const optional<date_t>& begin,
+			      const optional<date_t>& end) const
+{
+  const date_index_t& index(date_index());
+
+  std::size_t first = 0;
+  if (begin)
+    first = (std::lower_bound(index.dates.begin(), index.dates.end(),
+			      *begin) - index.dates.begin());
+
+  std::size_t last = index.dates.size();
+  if (end)
+    last = (std::lower_bound(index.dates.begin(), index.dates.end(),
+			     *end) - index.dates.begin());
+
+  if (first >= last)
+    return NULL_VALUE;
+
+  // For each commodity, the number of its postings before FIRST and
+  // before LAST picks out the two running totals that bound the range.
+  value_t total;
+  foreach (const date_index_t::series_map::value_type& pair, index.series) {
+    const date_index_t::series_t& series(pair.second);
+
+    std::size_t upto = (std::lower_bound(series.positions.begin(),
+					 series.positions.end(), last) -
+			series.positions.begin());
+    if (upto == 0)
+      continue;
+
+    std::size_t before = (std::lower_bound(series.positions.begin(),
+					   series.positions.begin() + upto,
+					   first) -
+			  series.positions.begin());
+    if (before == upto)
+      continue;
+
+    if (before == 0)
+      add_or_set_value(total, series.totals[upto - 1]);
+    else
+      add_or_set_value(total, series.totals[upto - 1] -
+		       series.totals[before - 1]);
+  }
+  return total;
+}
+
 value_t account_t::family_total(const optional<expr_t&>& expr) const
 {
-  if (! (xdata_ && xdata_->family_details.calculated)) {
+  if (! (has_xdata() && xdata_->family_details.calculated)) {
     const_cast<account_t&>(*this).xdata().family_details.calculated = true;
 
     value_t temp;
@@ -405,7 +524,7 @@ value_t account_t::family_total(const optional<expr_t&>& expr) const
 const account_t::xdata_t::details_t&
 account_t::self_details(bool gather_all) const
 {
-  if (! (xdata_ && xdata_->self_details.gathered)) {
+  if (! (has_xdata() && xdata_->self_details.gathered)) {
     const_cast<account_t&>(*this).xdata().self_details.gathered = true;
 
     foreach (const post_t * post, posts)
@@ -417,7 +536,7 @@ account_t::self_details(bool gather_all) const
 const account_t::xdata_t::details_t&
 account_t::family_details(bool gather_all) const
 {
-  if (! (xdata_ && xdata_->family_details.gathered)) {
+  if (! (has_xdata() && xdata_->family_details.gathered)) {
     const_cast<account_t&>(*this).xdata().family_details.gathered = true;
 
     foreach (const accounts_map::value_type& pair, accounts)
@@ -437,7 +556,7 @@ void account_t::xdata_t::details_t::update(post_t& post,
     posts_virtuals_count++;
 
   if (gather_all)
-    filenames.insert(post.pathname);
+    filenames.insert(post.pathname());
 
   date_t date = post.date();
 
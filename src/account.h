@@ -96,6 +96,13 @@ class account_t : public scope_t
   }
   ~account_t();
 
+  static void * operator new(std::size_t size) {
+    return slab_allocator_t<account_t>::allocate(size);
+  }
+  static void operator delete(void * ptr, std::size_t size) {
+    slab_allocator_t<account_t>::release(ptr, size);
+  }
+
   operator string() const {
     return fullname();
   }
@@ -116,6 +123,7 @@ class account_t : public scope_t
   void add_post(post_t * post) {
     posts.push_back(post);
   }
+  bool remove_post(post_t * post);
 
   virtual expr_t::ptr_op_t lookup(const string& name);
 
@@ -183,7 +191,9 @@ class account_t : public scope_t
 
     std::list<sort_value_t> sort_values;
 
-    xdata_t() : supports_flags<>()
+    std::size_t generation;
+
+    xdata_t() : supports_flags<>(), generation(xdata_generation)
     {
       TRACE_CTOR(account_t::xdata_t, "");
     }
@@ -191,7 +201,8 @@ class account_t : public scope_t
       : supports_flags<>(other.flags()),
 	self_details(other.self_details),
 	family_details(other.family_details),
-	sort_values(other.sort_values)
+	sort_values(other.sort_values),
+	generation(other.generation)
     {
       TRACE_CTOR(account_t::xdata_t, "copy");
     }
@@ -207,8 +218,12 @@ class account_t : public scope_t
   // moment.
   mutable optional<xdata_t> xdata_;
 
+  // As with post_t::xdata_generation, advancing this discards the
+  // extended data of every account at once.
+  static std::size_t xdata_generation;
+
   bool has_xdata() const {
-    return xdata_;
+    return xdata_ && xdata_->generation == xdata_generation;
   }
   void clear_xdata() {
     xdata_ = none;
@@ -216,21 +231,68 @@ class account_t : public scope_t
   xdata_t& xdata() {
     if (! xdata_)
       xdata_ = xdata_t();
+    else if (xdata_->generation != xdata_generation)
+      *xdata_ = xdata_t();
     return *xdata_;
   }
   const xdata_t& xdata() const {
-    assert(xdata_);
+    assert(has_xdata());
     return *xdata_;
   }
 
+  // This index holds the dates of `posts' in sorted order and, for each
+  // commodity they use, the running total of that commodity's amounts
+  // after each of its postings.  A posting adds one amount to one series,
+  // so the index grows with the number of postings and not with the
+  // number of commodities.  It is built the first time a total is asked
+  // for by date, and rebuilt only if postings are added or the meaning of
+  // a posting's date changes.
+  struct date_index_t
+  {
+    struct series_t
+    {
+      std::vector<std::size_t> positions; // indices into `dates'
+      std::vector<amount_t>    totals;
+    };
+
+    typedef std::map<const commodity_t *, series_t> series_map;
+
+    std::vector<date_t> dates;
+    series_map		series;
+    std::size_t		last_size;
+    bool		effective;
+
+    date_index_t() : last_size(0), effective(false) {
+      TRACE_CTOR(account_t::date_index_t, "");
+    }
+    date_index_t(const date_index_t& other)
+      : dates(other.dates), series(other.series),
+	last_size(other.last_size), effective(other.effective) {
+      TRACE_CTOR(account_t::date_index_t, "copy");
+    }
+    ~date_index_t() throw() {
+      TRACE_DTOR(account_t::date_index_t);
+    }
+  };
+
+  mutable optional<date_index_t> date_index_;
+
+  const date_index_t& date_index() const;
+  bool has_date_index() const;
+
   value_t self_total(const optional<expr_t&>& expr = none) const;
   value_t family_total(const optional<expr_t&>& expr = none) const;
 
+  // Return the sum of the amounts of this account's own postings dated
+  // on or after BEGIN and before END, or NULL_VALUE if there are none.
+  value_t self_total(const optional<date_t>& begin,
+		     const optional<date_t>& end) const;
+
   const xdata_t::details_t& self_details(bool gather_all = true) const;
   const xdata_t::details_t& family_details(bool gather_all = true) const;
 
   bool has_flags(xdata_t::flags_t flags) const {
-    return xdata_ && xdata_->has_flags(flags);
+    return has_xdata() && xdata_->has_flags(flags);
   }
   std::size_t children_with_flags(xdata_t::flags_t flags) const;
 };
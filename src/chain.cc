@@ -44,6 +44,7 @@ post_handler_ptr chain_post_handlers(report_t&	      report,
 				     bool             only_preliminaries)
 {
   post_handler_ptr handler(base_handler);
+  post_handler_ptr only_filter;
   item_predicate   display_predicate;
   item_predicate   only_predicate;
 
@@ -103,16 +104,30 @@ post_handler_ptr chain_post_handlers(report_t&	      report,
     only_predicate = item_predicate(report.HANDLER(only_).str(),
 				    report.what_to_keep());
     handler.reset(new filter_posts(handler, only_predicate, report));
+    only_filter = handler;
   }
 
   if (! only_preliminaries) {
     // sort_posts will sort all the posts it sees, based on the `sort_order'
     // value expression.
     if (report.HANDLED(sort_)) {
-      if (report.HANDLED(sort_xacts_))
+      if (report.HANDLED(sort_xacts_)) {
 	handler.reset(new sort_xacts(handler, report.HANDLER(sort_).str()));
-      else
-	handler.reset(new sort_posts(handler, report.HANDLER(sort_).str()));
+      } else {
+	// If truncate_xacts will keep only the first few xacts, and nothing
+	// between it and here can drop or add postings, only those xacts
+	// need to be sorted.
+	std::size_t head_count = 0;
+	if (report.HANDLED(head_) && ! report.HANDLED(tail_) &&
+	    ! report.HANDLED(only_) && ! report.HANDLED(display_) &&
+	    ! report.HANDLED(revalued)) {
+	  long count = report.HANDLER(head_).value.to_long();
+	  if (count > 0)
+	    head_count = static_cast<std::size_t>(count);
+	}
+	handler.reset(new sort_posts(handler, report.HANDLER(sort_).str(),
+				     head_count));
+      }
     }
 
     // collapse_posts causes xacts with multiple posts to appear as xacts
@@ -167,10 +182,29 @@ post_handler_ptr chain_post_handlers(report_t&	      report,
   if (report.HANDLED(limit_)) {
     DEBUG("report.predicate",
 	  "Report predicate expression = " << report.HANDLER(limit_).str());
-    handler.reset(new filter_posts
-		  (handler, item_predicate(report.HANDLER(limit_).str(),
-					   report.what_to_keep()),
-		   report));
+
+    // If the `secondary_predicate' filter would come right after this one,
+    // nothing in between can change a posting, so test both in a single
+    // filter_posts.  This is not done when forecasting, since
+    // forecast_posts relies on POST_EXT_MATCHES being set by the
+    // `predicate' alone.
+    if (only_filter && handler == only_filter &&
+	! report.HANDLED(forecast_while_)) {
+      DEBUG("report.predicate", "Fusing --limit and --only predicates");
+      handler = only_filter->handler;
+      handler.reset(new filter_posts
+		    (handler, item_predicate(string("(") +
+					     report.HANDLER(limit_).str() +
+					     ")&(" +
+					     report.HANDLER(only_).str() + ")",
+					     report.what_to_keep()),
+		     report));
+    } else {
+      handler.reset(new filter_posts
+		    (handler, item_predicate(report.HANDLER(limit_).str(),
+					     report.what_to_keep()),
+		     report));
+    }
   }
 
   // budget_posts takes a set of posts from a data file and uses them to
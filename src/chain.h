@@ -78,6 +78,17 @@ public:
     if (handler.get())
       handler->flush();
   }
+
+  /**
+   * Returns true once nothing more passed to this handler could change
+   * the output, because some handler downstream (such as truncate_xacts
+   * for --head) will accept no more items.  Iterators check this so that
+   * they can stop early.
+   */
+  virtual bool finished() const {
+    return handler.get() && handler->finished();
+  }
+
   virtual void operator()(T& item) {
     if (handler.get()) {
       check_for_signal();
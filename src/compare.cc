@@ -118,4 +118,232 @@ bool compare_items<account_t>::operator()(account_t * left, account_t * right)
   return sort_value_is_less_than(lxdata.sort_values, rxdata.sort_values);
 }
 
+namespace {
+  struct sort_column_t
+  {
+    expr_t		       term;
+    bool		       inverted;
+    bool		       encoded;
+    value_t::type_t	       type;
+    std::vector<value_t>       values;
+    std::vector<int_least64_t> keys;
+
+    sort_column_t(const expr_t::ptr_op_t& node, bool _inverted)
+      : term(node), inverted(_inverted), encoded(true),
+	type(value_t::VOID) {}
+  };
+
+  typedef std::vector<sort_column_t> sort_columns_t;
+
+  void find_sort_columns(sort_columns_t& columns, expr_t::ptr_op_t node)
+  {
+    if (node->kind == expr_t::op_t::O_CONS) {
+      find_sort_columns(columns, node->left());
+      find_sort_columns(columns, node->right());
+    }
+    else if (node->kind == expr_t::op_t::O_NEG) {
+      columns.push_back(sort_column_t(node->left(), true));
+    }
+    else {
+      columns.push_back(sort_column_t(node, false));
+    }
+  }
+
+  // Dates, datetimes and integers are encoded as integers which order
+  // exactly as the values themselves do, and which can be decoded back
+  // into the same values.
+  const date_t	   epoch_date(1970, 1, 1);
+  const datetime_t epoch(epoch_date);
+
+  bool encode_sort_value(const value_t& value, value_t::type_t type,
+			 int_least64_t& key)
+  {
+    if (value.type() != type)
+      return false;
+
+    switch (type) {
+    case value_t::DATE:
+      if (! is_valid(value.as_date()))
+	return false;
+      key = (value.as_date() - epoch_date).days();
+      return true;
+    case value_t::DATETIME:
+      if (! is_valid(value.as_datetime()))
+	return false;
+      key = (value.as_datetime() - epoch).ticks();
+      return true;
+    case value_t::INTEGER:
+      key = value.as_long();
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  value_t decode_sort_key(int_least64_t key, value_t::type_t type)
+  {
+    switch (type) {
+    case value_t::DATE:
+      return epoch_date + date_duration_t(static_cast<long>(key));
+    case value_t::DATETIME:
+      return datetime_t(epoch + time_duration_t(0, 0, 0, key));
+    default:
+      return static_cast<long>(key);
+    }
+  }
+
+  // Once a value turns up which cannot be encoded like those before it,
+  // the keys gathered so far are turned back into values, and the rest
+  // of the column is kept as values.
+  void decode_sort_column(sort_column_t& column)
+  {
+    column.values.reserve(column.keys.capacity());
+    foreach (int_least64_t key, column.keys)
+      column.values.push_back(decode_sort_key(key, column.type));
+
+    std::vector<int_least64_t>().swap(column.keys);
+    column.encoded = false;
+  }
+
+  class compare_keys
+  {
+    const sort_columns_t& columns;
+
+  public:
+    compare_keys(const sort_columns_t& _columns) : columns(_columns) {}
+
+    // This must agree with sort_value_is_less_than.
+    bool operator()(std::size_t left, std::size_t right) const {
+      foreach (const sort_column_t& column, columns) {
+	if (column.encoded) {
+	  if (column.keys[left] < column.keys[right])
+	    return ! column.inverted;
+	  else if (column.keys[left] > column.keys[right])
+	    return column.inverted;
+	} else {
+	  const value_t& lvalue(column.values[left]);
+	  const value_t& rvalue(column.values[right]);
+
+	  // Don't even try to sort balance values
+	  if (! lvalue.is_balance() && ! rvalue.is_balance()) {
+	    if (lvalue < rvalue)
+	      return ! column.inverted;
+	    else if (lvalue > rvalue)
+	      return column.inverted;
+	  }
+	}
+      }
+      return false;
+    }
+  };
+
+  // Orders equal postings by their original position, making this a
+  // total order that agrees with std::stable_sort using compare_keys.
+  class compare_keys_stably : public compare_keys
+  {
+  public:
+    compare_keys_stably(const sort_columns_t& _columns)
+      : compare_keys(_columns) {}
+
+    bool operator()(std::size_t left, std::size_t right) const {
+      if (compare_keys::operator()(left, right))
+	return true;
+      else if (compare_keys::operator()(right, left))
+	return false;
+      else
+	return left < right;
+    }
+  };
+
+  // Put in order just enough of `order' to cover the first `head_count'
+  // runs of postings from the same xact, and return how many postings
+  // those runs hold.  The prefix is doubled until it reaches the first
+  // posting of the next run.
+  std::size_t order_head(std::vector<std::size_t>&	order,
+			 const std::deque<post_t *>&	posts,
+			 const sort_columns_t&		columns,
+			 std::size_t			head_count)
+  {
+    compare_keys_stably compare(columns);
+
+    for (std::size_t prefix = head_count + 1; ; prefix *= 2) {
+      if (prefix >= order.size()) {
+	std::sort(order.begin(), order.end(), compare);
+	return order.size();
+      }
+
+      std::partial_sort(order.begin(), order.begin() + prefix, order.end(),
+			compare);
+
+      xact_t *	  last_xact = posts[order[0]]->xact;
+      std::size_t runs	    = 1;
+      for (std::size_t i = 1; i < prefix; i++) {
+	if (posts[order[i]]->xact != last_xact) {
+	  last_xact = posts[order[i]]->xact;
+	  if (++runs > head_count)
+	    return i;
+	}
+      }
+    }
+  }
+}
+
+void sort_posts_by_keys(std::deque<post_t *>& posts, const expr_t& sort_order,
+			std::size_t head_count)
+{
+  if (posts.size() < 2)
+    return;
+
+  sort_columns_t columns;
+  find_sort_columns(columns, sort_order.get_op());
+
+  // Only the encoded keys are kept for a column of dates or integers, so
+  // that sorting a large report does not hold on to a value_t for every
+  // sort term of every posting.
+  foreach (sort_column_t& column, columns) {
+    column.keys.reserve(posts.size());
+
+    foreach (post_t * post, posts) {
+      value_t value(column.term.calc(*post).simplified());
+      if (value.is_null())
+	throw_(calc_error,
+	       _("Could not determine sorting value based an expression"));
+
+      if (column.encoded) {
+	if (column.type == value_t::VOID)
+	  column.type = value.type();
+
+	int_least64_t key;
+	if (encode_sort_value(value, column.type, key)) {
+	  column.keys.push_back(key);
+	  continue;
+	}
+	decode_sort_column(column);
+      }
+      column.values.push_back(value);
+    }
+
+    DEBUG("value.sort", "Sort column " << column.term
+	  << (column.encoded ? " compared as integer keys" :
+	      " compared as values"));
+  }
+
+  std::vector<std::size_t> order(posts.size());
+  for (std::size_t i = 0; i < order.size(); i++)
+    order[i] = i;
+
+  std::size_t count = order.size();
+  if (head_count > 0)
+    count = order_head(order, posts, columns, head_count);
+  else
+    std::stable_sort(order.begin(), order.end(), compare_keys(columns));
+
+  std::vector<post_t *> sorted;
+  sorted.reserve(count);
+  for (std::size_t i = 0; i < count; i++)
+    sorted.push_back(posts[order[i]]);
+
+  posts.assign(sorted.begin(), sorted.end());
+}
+
 } // namespace ledger
@@ -97,6 +97,19 @@ template <>
 bool compare_items<account_t>::operator()(account_t * left,
 					  account_t * right);
 
+/**
+ * Stable sort `posts' by `sort_order', giving the same order as
+ * compare_items<post_t> would.  Each posting's sort values are computed
+ * once, up front, into one column per sort term; a column holding only
+ * dates or integers is then compared as plain integer keys.
+ *
+ * If `head_count' is non-zero, only the postings belonging to the first
+ * `head_count' xacts in sorted order (as truncate_xacts counts them) are
+ * kept, and the rest are never fully sorted.
+ */
+void sort_posts_by_keys(std::deque<post_t *>& posts, const expr_t& sort_order,
+			std::size_t head_count = 0);
+
 } // namespace ledger
 
 #endif // _COMPARE_H
@@ -242,20 +242,16 @@ namespace {
     if (tmpl.payee_mask.empty())
       throw std::runtime_error(_("xact' command requires at least a payee"));
 
-    xact_t *		  matching = NULL;
     journal_t&		  journal(*report.session.journal.get());
+    xact_t *		  matching(journal.last_xact_with_payee
+				   (tmpl.payee_mask));
     std::auto_ptr<xact_t> added(new xact_t);
 
-    for (xacts_list::reverse_iterator j = journal.xacts.rbegin();
-	 j != journal.xacts.rend();
-	 j++) {
-      if (tmpl.payee_mask.match((*j)->payee)) {
-	matching = *j;
-	DEBUG("derive.xact",
-	      "Found payee match: transaction on line " << (*j)->beg_line);
-	break;
-      }
-    }
+#if defined(DEBUG_ON)
+    if (matching)
+      DEBUG("derive.xact",
+	    "Found payee match: transaction on line " << matching->beg_line);
+#endif
 
     if (! tmpl.date) {
       added->_date = CURRENT_DATE();
@@ -465,6 +461,7 @@ namespace {
     if (! journal.xact_finalize_hooks.run_hooks(*added.get(), false) ||
 	! added->finalize() ||
 	! journal.xact_finalize_hooks.run_hooks(*added.get(), true)) {
+      journal.unhook_posts(*added.get());
       throw_(std::runtime_error,
 	     _("Failed to finalize derived transaction (check commodities)"));
     }
@@ -505,10 +502,21 @@ value_t xact_command(call_scope_t& args)
   // jww (2009-02-27): make this more general
   report.HANDLER(limit_).on(string("#xact"), "actual");
 
-  report.xact_report(post_handler_ptr
-		      (new format_posts(report,
-					report.HANDLER(print_format_).str())),
-		      *new_xact.get());
+  // finalize added the new xact's postings to their accounts, but the
+  // xact is never added to the journal, so they must be taken out of
+  // those accounts again before it is deleted.
+  journal_t& journal(*report.session.journal.get());
+  try {
+    report.xact_report(post_handler_ptr
+			(new format_posts(report,
+					  report.HANDLER(print_format_).str())),
+			*new_xact.get());
+  }
+  catch (...) {
+    journal.unhook_posts(*new_xact.get());
+    throw;
+  }
+  journal.unhook_posts(*new_xact.get());
   return true;
 }
 
@@ -40,7 +40,7 @@ namespace ledger {
 
 void format_emacs_posts::write_xact(xact_t& xact)
 {
-  out << "\"" << xact.pathname << "\" "
+  out << "\"" << xact.pathname() << "\" "
       << (static_cast<std::size_t>(xact.beg_line) + 1) << " ";
 
   tm	      when = gregorian::to_tm(xact.date());
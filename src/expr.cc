@@ -73,7 +73,7 @@ expr_t::~expr_t() throw()
   TRACE_DTOR(expr_t);
 }
 
-expr_t::ptr_op_t expr_t::get_op() throw()
+expr_t::ptr_op_t expr_t::get_op() const throw()
 {
   return ptr;
 }
@@ -142,6 +142,11 @@ value_t expr_t::calc(scope_t& scope)
       }
     }
 
+#if defined(PROFILE_ON)
+    if (expr_profiling_enabled)
+      profile_expr(ptr, str);
+#endif
+
     ptr_op_t locus;
     try {
       return ptr->calc(scope, &locus);
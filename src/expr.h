@@ -115,7 +115,7 @@ public:
     return ptr.get() != NULL;
   }
 
-  ptr_op_t get_op() throw();
+  ptr_op_t get_op() const throw();
 
   string text() const throw() {
     return str;
@@ -53,6 +53,13 @@ pass_down_posts::pass_down_posts(post_handler_ptr handler,
       add_error_context(item_context(*post, _("While handling posting")));
       throw;
     }
+
+    // Stop walking the journal once the rest of it could not change
+    // the report.
+    if (finished()) {
+      DEBUG("filters.pass_down", "Stopping early: no more posts wanted");
+      break;
+    }
   }
 
   item_handler<post_t>::flush();
@@ -122,8 +129,7 @@ void truncate_xacts::operator()(post_t& post)
 
 void sort_posts::post_accumulated_posts()
 {
-  std::stable_sort(posts.begin(), posts.end(),
-		   compare_items<post_t>(sort_order));
+  sort_posts_by_keys(posts, sort_order, head_count);
 
   foreach (post_t * post, posts) {
     post->xdata().drop_flags(POST_EXT_SORT_CALC);
@@ -222,7 +228,12 @@ void calc_posts::operator()(post_t& post)
     xdata.count = 1;
   }
 
-  post.add_to_value(xdata.visited_value, amount_expr);
+  // The default amount expression is just "amount", which needs no scope
+  // or expression evaluation to compute.
+  if (native_amount)
+    add_or_set_value(xdata.visited_value, post.amount_value());
+  else
+    post.add_to_value(xdata.visited_value, amount_expr);
   xdata.add_flags(POST_EXT_VISITED);
 
   account_t * acct = post.reported_account();
@@ -511,6 +522,15 @@ void changed_value_posts::operator()(post_t& post)
   last_post = &post;
 }
 
+void subtotal_posts::sort_values(sorted_values_t& sorted)
+{
+  sorted.reserve(values.size());
+  foreach (values_map::value_type& pair, values)
+    sorted.push_back(sorted_value_t(pair.first->fullname(), &pair.second));
+
+  std::sort(sorted.begin(), sorted.end());
+}
+
 void subtotal_posts::report_subtotal(const char *		      spec_fmt,
 				     const optional<date_interval_t>& interval)
 {
@@ -547,8 +567,11 @@ void subtotal_posts::report_subtotal(const char *		      spec_fmt,
   xact.payee = out_date.str();
   xact._date = *range_start;
 
-  foreach (values_map::value_type& pair, values)
-    handle_value(pair.second.value, pair.second.account, &xact, post_temps,
+  sorted_values_t sorted;
+  sort_values(sorted);
+
+  foreach (sorted_value_t& pair, sorted)
+    handle_value(pair.second->value, pair.second->account, &xact, post_temps,
 		 *handler);
 
   values.clear();
@@ -561,12 +584,12 @@ void subtotal_posts::operator()(post_t& post)
   account_t * acct = post.reported_account();
   assert(acct);
 
-  values_map::iterator i = values.find(acct->fullname());
+  values_map::iterator i = values.find(acct);
   if (i == values.end()) {
     value_t temp;
     post.add_to_value(temp, amount_expr);
     std::pair<values_map::iterator, bool> result
-      = values.insert(values_pair(acct->fullname(), acct_value_t(acct, temp)));
+      = values.insert(values_pair(acct, acct_value_t(acct, temp)));
     assert(result.second);
   } else {
     post.add_to_value((*i).second.value, amount_expr);
@@ -658,11 +681,14 @@ void posts_as_equity::report_subtotal()
   xact.payee = _("Opening Balances");
   xact._date = finish;
 
+  sorted_values_t sorted;
+  sort_values(sorted);
+
   value_t total = 0L;
-  foreach (values_map::value_type& pair, values) {
-    handle_value(pair.second.value, pair.second.account, &xact, post_temps,
+  foreach (sorted_value_t& pair, sorted) {
+    handle_value(pair.second->value, pair.second->account, &xact, post_temps,
 		 *handler);
-    total += pair.second.value;
+    total += pair.second->value;
   }
   values.clear();
 
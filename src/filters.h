@@ -154,6 +154,11 @@ public:
 
   virtual void flush();
   virtual void operator()(post_t& post);
+
+  virtual bool finished() const {
+    return (tail_count == 0 && head_count > 0 &&
+	    static_cast<int>(xacts_seen) >= head_count);
+  }
 };
 
 /**
@@ -167,23 +172,26 @@ class sort_posts : public item_handler<post_t>
 
   posts_deque  posts;
   const expr_t sort_order;
+  std::size_t  head_count;
 
   sort_posts();
 
 public:
   sort_posts(post_handler_ptr handler,
-		    const expr_t&    _sort_order)
+		    const expr_t&    _sort_order,
+		    std::size_t      _head_count = 0)
     : item_handler<post_t>(handler),
-      sort_order(_sort_order) {
+      sort_order(_sort_order), head_count(_head_count) {
     TRACE_CTOR(sort_posts,
-	       "post_handler_ptr, const value_expr&");
+	       "post_handler_ptr, const value_expr&, std::size_t");
   }
   sort_posts(post_handler_ptr handler,
-		    const string& _sort_order)
+		    const string& _sort_order,
+		    std::size_t   _head_count = 0)
     : item_handler<post_t>(handler),
-      sort_order(_sort_order) {
+      sort_order(_sort_order), head_count(_head_count) {
     TRACE_CTOR(sort_posts,
-	       "post_handler_ptr, const string&");
+	       "post_handler_ptr, const string&, std::size_t");
   }
   virtual ~sort_posts() {
     TRACE_DTOR(sort_posts);
@@ -235,6 +243,10 @@ public:
     item_handler<post_t>::flush();
   }
 
+  virtual bool finished() const {
+    return sorter.finished();
+  }
+
   virtual void operator()(post_t& post) {
     if (last_xact && post.xact != last_xact)
       sorter.post_accumulated_posts();
@@ -320,6 +332,7 @@ class calc_posts : public item_handler<post_t>
   post_t * last_post;
   expr_t&  amount_expr;
   bool     account_wise;
+  bool     native_amount;
 
   calc_posts();
 
@@ -328,7 +341,8 @@ public:
 	     expr_t&          _amount_expr,
 	     bool             _account_wise = false)
     : item_handler<post_t>(handler), last_post(NULL),
-      amount_expr(_amount_expr), account_wise(_account_wise) {
+      amount_expr(_amount_expr), account_wise(_account_wise),
+      native_amount(_amount_expr.text() == "amount") {
     TRACE_CTOR(calc_posts, "post_handler_ptr, expr_t&, bool");
   }
   virtual ~calc_posts() {
@@ -509,8 +523,13 @@ protected:
     }
   };
 
-  typedef std::map<string, acct_value_t>  values_map;
-  typedef std::pair<string, acct_value_t> values_pair;
+  // Subtotals are gathered by account, and put in order by name only
+  // when they are reported.
+  typedef std::map<account_t *, acct_value_t>  values_map;
+  typedef std::pair<account_t *, acct_value_t> values_pair;
+
+  typedef std::pair<string, acct_value_t *>    sorted_value_t;
+  typedef std::vector<sorted_value_t>	       sorted_values_t;
 
 protected:
   expr_t&	      amount_expr;
@@ -533,6 +552,8 @@ public:
     clear_xacts_posts(xact_temps);
   }
 
+  void sort_values(sorted_values_t& sorted);
+
   void report_subtotal(const char *			spec_fmt = NULL,
 		       const optional<date_interval_t>& interval = none);
 
@@ -259,6 +259,7 @@ void global_scope_t::report_options(report_t& report, std::ostream& out)
   HANDLER(args_only).report(out);
   HANDLER(debug_).report(out);
   HANDLER(init_file_).report(out);
+  HANDLER(profile_exprs).report(out);
   HANDLER(script_).report(out);
   HANDLER(trace_).report(out);
   HANDLER(verbose).report(out);
@@ -297,6 +298,9 @@ option_t<global_scope_t> * global_scope_t::lookup_option(const char * p)
   case 'o':
     OPT(options);
     break;
+  case 'p':
+    OPT(profile_exprs);
+    break;
   case 's':
     OPT(script_);
     break;
@@ -459,6 +463,10 @@ void global_scope_t::normalize_report_options(const string& verb)
     }
   }
 
+  if (rep.HANDLED(depth_) && verb != "pivot")
+    rep.HANDLER(display_).on(string("--depth"),
+			     string("depth<=") + rep.HANDLER(depth_).str());
+
   if (! rep.HANDLED(empty))
     rep.HANDLER(display_).on(string("?normalize"), "amount|(!post&total)");
 
@@ -596,6 +604,11 @@ void handle_debug_options(int argc, char * argv[])
       else if (std::strcmp(argv[i], "--verify") == 0) {
 #if defined(VERIFY_ON)
 	verify_enabled = true; // global in utils.h
+#endif
+      }
+      else if (std::strcmp(argv[i], "--profile-exprs") == 0) {
+#if defined(PROFILE_ON)
+	expr_profiling_enabled = true; // global in op.h
 #endif
       }
       else if (std::strcmp(argv[i], "--verbose") == 0 ||
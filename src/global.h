@@ -141,6 +141,7 @@ See LICENSE file included with the distribution for details and disclaimer.");
    });
 
   OPTION(global_scope_t, options);
+  OPTION(global_scope_t, profile_exprs);
   OPTION(global_scope_t, script_);
   OPTION(global_scope_t, trace_);
   OPTION(global_scope_t, verbose);
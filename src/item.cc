@@ -37,6 +37,28 @@ namespace ledger {
 
 bool item_t::use_effective_date = false;
 
+std::vector<path> item_t::source_files;
+
+uint_least32_t item_t::add_source_file(const path& pathname)
+{
+  for (std::size_t i = 0; i < source_files.size(); i++)
+    if (source_files[i] == pathname)
+      return static_cast<uint_least32_t>(i + 1);
+
+  source_files.push_back(pathname);
+  return static_cast<uint_least32_t>(source_files.size());
+}
+
+const path& item_t::pathname() const
+{
+  static path no_file;
+  if (source_file == 0)
+    return no_file;
+
+  assert(source_file <= source_files.size());
+  return source_files[source_file - 1];
+}
+
 bool item_t::has_tag(const string& tag) const
 {
   DEBUG("item.meta", "Checking if item has tag: " << tag);
@@ -104,7 +126,7 @@ void item_t::set_tag(const string&           tag,
 		     const optional<string>& value)
 {
   if (! metadata)
-    metadata = string_map();
+    metadata.reset(new string_map);
 
   DEBUG("item.meta", "Setting tag '" << tag << "' to value '"
 	<< (value ? *value : string("<none>")) << "'");
@@ -224,7 +246,7 @@ namespace {
   }
 
   value_t get_pathname(item_t& item) {
-    return string_value(item.pathname.string());
+    return string_value(item.pathname().string());
   }
 
   value_t get_beg_pos(item_t& item) {
@@ -397,7 +419,7 @@ bool item_t::valid() const
 
 void print_item(std::ostream& out, const item_t& item, const string& prefix)
 {
-  out << source_context(item.pathname, item.beg_pos, item.end_pos, prefix);
+  out << source_context(item.pathname(), item.beg_pos, item.end_pos, prefix);
 }
 
 string item_context(const item_t& item, const string& desc)
@@ -411,12 +433,12 @@ string item_context(const item_t& item, const string& desc)
 
   std::ostringstream out;
       
-  if (item.pathname == path("/dev/stdin")) {
+  if (item.pathname() == path("/dev/stdin")) {
     out << desc << _(" from standard input:");
     return out.str();
   }
 
-  out << desc << _(" from \"") << item.pathname.string() << "\"";
+  out << desc << _(" from \"") << item.pathname().string() << "\"";
 
   if (item.beg_line != item.end_line)
     out << _(", lines ") << item.beg_line << "-"
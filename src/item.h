@@ -70,10 +70,16 @@ public:
   optional<date_t>   _date_eff;
   optional<string>   note;
 
+  // Few items have metadata, so it is kept out of line, and an item
+  // without any pays only for a null pointer.
   typedef std::map<string, optional<string> > string_map;
-  optional<string_map> metadata;
+  scoped_ptr<string_map> metadata;
 
-  path               pathname;
+  // The file an item was read from is kept as an index into
+  // source_files, so that each file's path is stored only once, rather
+  // than once for every transaction and posting read from it.  Zero
+  // means the item was not read from a file.
+  uint_least32_t     source_file;
   istream_pos_type   beg_pos;
   std::size_t	     beg_line;
   istream_pos_type   end_pos;
@@ -81,7 +87,7 @@ public:
 
   item_t(flags_t _flags = ITEM_NORMAL, const optional<string>& _note = none)
     : supports_flags<>(_flags), _state(UNCLEARED), note(_note),
-      beg_pos(0), beg_line(0), end_pos(0), end_line(0)
+      source_file(0), beg_pos(0), beg_line(0), end_pos(0), end_line(0)
   {
     TRACE_CTOR(item_t, "flags_t, const string&");
   }
@@ -104,11 +110,11 @@ public:
 
     note      = item.note;
 
-    pathname  = item.pathname;
-    beg_pos   = item.beg_pos;
-    beg_line  = item.beg_line;
-    end_pos   = item.end_pos;
-    end_line  = item.end_line;
+    source_file = item.source_file;
+    beg_pos     = item.beg_pos;
+    beg_line    = item.beg_line;
+    end_pos     = item.end_pos;
+    end_line    = item.end_line;
   }
 
   virtual bool operator==(const item_t& xact) {
@@ -134,6 +140,13 @@ public:
 
   static bool use_effective_date;
 
+  static std::vector<path> source_files;
+
+  // Return the index in source_files of PATHNAME, adding it if needed.
+  static uint_least32_t add_source_file(const path& pathname);
+
+  const path& pathname() const;
+
   virtual date_t date() const {
     assert(_date);
     if (use_effective_date)
@@ -74,6 +74,110 @@ post_t * journal_posts_iterator::operator()()
   return post;
 }
 
+void selected_posts_iterator::reset(const std::vector<xact_t *>& _xacts)
+{
+  xacts = _xacts;
+  start();
+}
+
+void selected_posts_iterator::start()
+{
+  xacts_i = xacts.begin();
+
+  if (xacts_i != xacts.end())
+    posts.reset(**xacts_i++);
+}
+
+post_t * selected_posts_iterator::operator()()
+{
+  post_t * post = posts();
+  while (post == NULL && xacts_i != xacts.end()) {
+    posts.reset(**xacts_i++);
+    post = posts();
+  }
+  return post;
+}
+
+void dated_posts_iterator::reset(journal_t&		   journal,
+				 const optional<date_t>& begin,
+				 const optional<date_t>& end)
+{
+  journal.xacts_in_range(begin, end, xacts);
+  start();
+}
+
+// Move past any postings of `index's account which belong to xacts no
+// longer in the journal, and return whether any postings remain.
+bool account_posts_iterator::skip_foreign_posts(std::size_t index)
+{
+  const posts_deque& posts(accounts[index]->posts);
+  while (positions[index] != posts.end() &&
+	 (! (*positions[index])->xact ||
+	  (*positions[index])->xact->journal != journal))
+    ++positions[index];
+  return positions[index] != posts.end();
+}
+
+void account_posts_iterator::reset(journal_t&			   _journal,
+				   const std::vector<account_t *>& _accounts)
+{
+  journal  = &_journal;
+  accounts = _accounts;
+  std::sort(accounts.begin(), accounts.end());
+
+  positions.clear();
+  heap.clear();
+  for (std::size_t i = 0; i < accounts.size(); i++) {
+    positions.push_back(accounts[i]->posts.begin());
+    if (skip_foreign_posts(i))
+      heap.push_back(cursor_t((*positions[i])->xact->sequence, i));
+  }
+  std::make_heap(heap.begin(), heap.end(), std::greater<cursor_t>());
+
+  xact = NULL;
+}
+
+post_t * account_posts_iterator::operator()()
+{
+  for (;;) {
+    if (xact) {
+      while (posts_i != xact->posts.end()) {
+	post_t * post = *posts_i++;
+	if (std::binary_search(accounts.begin(), accounts.end(),
+			       post->account))
+	  return post;
+      }
+      xact = NULL;
+    }
+
+    if (heap.empty())
+      return NULL;
+
+    // Take the earliest xact among the accounts' next postings, and move
+    // every account holding postings in that xact past them.
+    std::size_t sequence = heap.front().first;
+    xact = (*positions[heap.front().second])->xact;
+
+    while (! heap.empty() && heap.front().first == sequence) {
+      std::pop_heap(heap.begin(), heap.end(), std::greater<cursor_t>());
+      std::size_t index = heap.back().second;
+      heap.pop_back();
+
+      const posts_deque& posts(accounts[index]->posts);
+      while (positions[index] != posts.end() &&
+	     (*positions[index])->xact == xact)
+	++positions[index];
+
+      if (skip_foreign_posts(index)) {
+	heap.push_back(cursor_t((*positions[index])->xact->sequence, index));
+	std::push_heap(heap.begin(), heap.end(), std::greater<cursor_t>());
+      }
+    }
+
+    posts_i = xact->posts.begin();
+  }
+}
+
 void posts_commodities_iterator::reset(journal_t& journal)
 {
   journal_posts.reset(journal);
@@ -161,6 +161,98 @@ public:
   virtual post_t * operator()();
 };
 
+/**
+ * Visit the postings of each xact in `xacts', in the order given.
+ */
+class selected_posts_iterator : public posts_iterator
+{
+protected:
+  std::vector<xact_t *>			xacts;
+  std::vector<xact_t *>::const_iterator xacts_i;
+  xact_posts_iterator			posts;
+
+  selected_posts_iterator() {
+    TRACE_CTOR(selected_posts_iterator, "");
+  }
+
+public:
+  selected_posts_iterator(const std::vector<xact_t *>& _xacts) {
+    TRACE_CTOR(selected_posts_iterator, "const std::vector<xact_t *>&");
+    reset(_xacts);
+  }
+  virtual ~selected_posts_iterator() throw() {
+    TRACE_DTOR(selected_posts_iterator);
+  }
+
+  void reset(const std::vector<xact_t *>& _xacts);
+
+  virtual post_t * operator()();
+
+protected:
+  void start();
+};
+
+/**
+ * Visit, in journal order, the postings of only those xacts which
+ * journal_t::xacts_in_range finds may hold postings dated from `begin'
+ * up to `end'.  Since some postings outside the range may still be
+ * visited, this only narrows what a date predicate must then test.
+ */
+class dated_posts_iterator : public selected_posts_iterator
+{
+public:
+  dated_posts_iterator(journal_t&	       journal,
+		       const optional<date_t>& begin,
+		       const optional<date_t>& end) {
+    TRACE_CTOR(dated_posts_iterator,
+	       "journal_t&, const optional<date_t>&, const optional<date_t>&");
+    reset(journal, begin, end);
+  }
+  virtual ~dated_posts_iterator() throw() {
+    TRACE_DTOR(dated_posts_iterator);
+  }
+
+  void reset(journal_t&		     journal,
+	     const optional<date_t>& begin,
+	     const optional<date_t>& end);
+};
+
+/**
+ * Visit, in journal order, only the postings made to `accounts'.  Each
+ * account's postings are already in journal order, so they are merged by
+ * the sequence numbers of their xacts; the postings of each xact reached
+ * are then visited in the order the xact lists them.
+ */
+class account_posts_iterator : public posts_iterator
+{
+  typedef std::pair<std::size_t, std::size_t> cursor_t;
+
+  journal_t *				 journal;
+  std::vector<account_t *>		 accounts;
+  std::vector<posts_deque::const_iterator> positions;
+  std::vector<cursor_t>			 heap;
+
+  xact_t *		     xact;
+  posts_list::const_iterator posts_i;
+
+  bool skip_foreign_posts(std::size_t index);
+
+public:
+  account_posts_iterator(journal_t&			 _journal,
+			 const std::vector<account_t *>& _accounts) {
+    TRACE_CTOR(account_posts_iterator,
+	       "journal_t&, const std::vector<account_t *>&");
+    reset(_journal, _accounts);
+  }
+  virtual ~account_posts_iterator() throw() {
+    TRACE_DTOR(account_posts_iterator);
+  }
+
+  void reset(journal_t& _journal, const std::vector<account_t *>& _accounts);
+
+  virtual post_t * operator()();
+};
+
 /**
  * @brief Brief
  *
@@ -33,7 +33,9 @@
 
 #include "journal.h"
 #include "xact.h"
+#include "post.h"
 #include "account.h"
+#include "mask.h"
 
 namespace ledger {
 
@@ -74,18 +76,69 @@ account_t * journal_t::find_account_re(const string& regexp)
   return master->find_account_re(regexp);
 }
 
+namespace {
+  typedef std::set<string>		     tag_names_t;
+  typedef std::set<std::pair<string, string> > tag_values_t;
+
+  void gather_tags(const item_t& item, tag_names_t& names,
+		   tag_values_t& values)
+  {
+    if (! item.metadata)
+      return;
+
+    foreach (const item_t::string_map::value_type& data, *item.metadata) {
+      names.insert(data.first);
+      if (data.second)
+	values.insert(std::pair<string, string>(data.first, *data.second));
+    }
+  }
+
+  void gather_xact_tags(const xact_t& xact, tag_names_t& names,
+			tag_values_t& values)
+  {
+    gather_tags(xact, names, values);
+    foreach (const post_t * post, xact.posts)
+      gather_tags(*post, names, values);
+  }
+
+  template <typename Map>
+  void remove_from_index(Map& index, const typename Map::key_type& key,
+			 xact_t * xact)
+  {
+    typename Map::iterator i = index.find(key);
+    if (i != index.end()) {
+      i->second.erase(std::remove(i->second.begin(), i->second.end(), xact),
+		      i->second.end());
+      if (i->second.empty())
+	index.erase(i);
+    }
+  }
+}
+
 bool journal_t::add_xact(xact_t * xact)
 {
   xact->journal = this;
 
   if (! xact_finalize_hooks.run_hooks(*xact, false) ||
-      ! xact->finalize() ||
-      ! xact_finalize_hooks.run_hooks(*xact, true)) {
+      ! xact->finalize()) {
+    xact->journal = NULL;
+    return false;
+  }
+
+  if (! xact_finalize_hooks.run_hooks(*xact, true)) {
+    unhook_posts(*xact);
     xact->journal = NULL;
     return false;
   }
 
+  xact->sequence = ++xacts_added;
   xacts.push_back(xact);
+  date_index_ = none;
+
+  if (payee_index_)
+    (*payee_index_)[xact->payee].push_back(xact);
+  if (tag_index_)
+    tag_index_->add_xact(xact);
 
   return true;
 }
@@ -103,11 +156,196 @@ bool journal_t::remove_xact(xact_t * xact)
     return false;
 
   xacts.erase(i);
+  unhook_posts(*xact);
   xact->journal = NULL;
+  date_index_	= none;
+
+  if (payee_index_)
+    remove_from_index(*payee_index_, xact->payee, xact);
+  if (tag_index_)
+    tag_index_->remove_xact(xact);
 
   return true;
 }
 
+void journal_t::unhook_posts(xact_t& xact)
+{
+  foreach (post_t * post, xact.posts)
+    if (post->account)
+      post->account->remove_post(post);
+}
+
+const journal_t::date_index_t& journal_t::date_index()
+{
+  if (date_index_ && date_index_->last_size == xacts.size() &&
+      date_index_->effective == item_t::use_effective_date)
+    return *date_index_;
+
+  date_index_ = date_index_t();
+  date_index_->entries.reserve(xacts.size());
+
+  std::size_t position = 0;
+  foreach (xact_t * xact, xacts) {
+    optional<date_t> earliest;
+    optional<date_t> latest;
+    foreach (post_t * post, xact->posts) {
+      date_t date = post->date();
+      if (! earliest || date < *earliest)
+	earliest = date;
+      if (! latest || date > *latest)
+	latest = date;
+    }
+
+    if (earliest) {
+      date_index_t::entry_t entry;
+      entry.earliest = *earliest;
+      entry.position = position;
+      entry.xact     = xact;
+      date_index_->entries.push_back(entry);
+
+      long spread = (*latest - *earliest).days();
+      if (spread > date_index_->spread)
+	date_index_->spread = spread;
+    }
+    ++position;
+  }
+
+  std::stable_sort(date_index_->entries.begin(),
+		   date_index_->entries.end());
+
+  date_index_->last_size = xacts.size();
+  date_index_->effective = item_t::use_effective_date;
+
+  DEBUG("journal.date_index", "Indexed " << date_index_->entries.size()
+	<< " xacts, with postings spread over at most "
+	<< date_index_->spread << " days");
+
+  return *date_index_;
+}
+
+namespace {
+  typedef journal_t::date_index_t::entry_t date_entry_t;
+
+  // Orders entries before a date when none of their xact's postings can
+  // fall on or after it, given the index's spread.
+  struct ends_before
+  {
+    long spread;
+
+    ends_before(long _spread) : spread(_spread) {}
+
+    bool operator()(const date_entry_t& entry, const date_t& date) const {
+      return (date - entry.earliest).days() > spread;
+    }
+  };
+
+  struct starts_before
+  {
+    bool operator()(const date_entry_t& entry, const date_t& date) const {
+      return entry.earliest < date;
+    }
+  };
+
+  bool earlier_position(const date_entry_t * left, const date_entry_t * right)
+  {
+    return left->position < right->position;
+  }
+}
+
+void journal_t::xacts_in_range(const optional<date_t>& begin,
+			       const optional<date_t>& end,
+			       std::vector<xact_t *>&  result)
+{
+  const date_index_t& index(date_index());
+
+  std::vector<date_entry_t>::const_iterator first = index.entries.begin();
+  if (begin)
+    first = std::lower_bound(index.entries.begin(), index.entries.end(),
+			     *begin, ends_before(index.spread));
+
+  std::vector<date_entry_t>::const_iterator last = index.entries.end();
+  if (end)
+    last = std::lower_bound(first, index.entries.end(), *end,
+			    starts_before());
+
+  std::vector<const date_entry_t *> found;
+  found.reserve(last - first);
+  for (; first != last; ++first)
+    found.push_back(&*first);
+
+  std::sort(found.begin(), found.end(), earlier_position);
+
+  result.clear();
+  result.reserve(found.size());
+  foreach (const date_entry_t * entry, found)
+    result.push_back(entry->xact);
+}
+
+const journal_t::payee_index_t& journal_t::payee_index()
+{
+  if (! payee_index_) {
+    payee_index_ = payee_index_t();
+    foreach (xact_t * xact, xacts)
+      (*payee_index_)[xact->payee].push_back(xact);
+
+    DEBUG("journal.payee_index", "Indexed " << xacts.size()
+	  << " xacts under " << payee_index_->size() << " payees");
+  }
+  return *payee_index_;
+}
+
+xact_t * journal_t::last_xact_with_payee(const mask_t& mask)
+{
+  xact_t * last = NULL;
+  foreach (const payee_index_t::value_type& pair, payee_index())
+    if ((! last || earlier_xact(last, pair.second.back())) &&
+	mask.match(pair.first))
+      last = pair.second.back();
+  return last;
+}
+
+void journal_t::tag_index_t::add_xact(xact_t * xact)
+{
+  tag_names_t  xact_names;
+  tag_values_t xact_values;
+  gather_xact_tags(*xact, xact_names, xact_values);
+
+  foreach (const string& name, xact_names)
+    names[name].push_back(xact);
+  foreach (const tag_values_t::value_type& value, xact_values)
+    values[value].push_back(xact);
+}
+
+void journal_t::tag_index_t::remove_xact(xact_t * xact)
+{
+  tag_names_t  xact_names;
+  tag_values_t xact_values;
+  gather_xact_tags(*xact, xact_names, xact_values);
+
+  foreach (const string& name, xact_names)
+    remove_from_index(names, name, xact);
+  foreach (const tag_values_t::value_type& value, xact_values)
+    remove_from_index(values, value, xact);
+}
+
+const journal_t::tag_index_t& journal_t::tag_index()
+{
+  if (! tag_index_) {
+    tag_index_ = tag_index_t();
+    foreach (xact_t * xact, xacts)
+      tag_index_->add_xact(xact);
+
+    DEBUG("journal.tag_index", "Indexed " << tag_index_->names.size()
+	  << " tags, with " << tag_index_->values.size() << " values");
+  }
+  return *tag_index_;
+}
+
+bool journal_t::earlier_xact(const xact_t * left, const xact_t * right)
+{
+  return left->sequence < right->sequence;
+}
+
 bool journal_t::valid() const
 {
   if (! master->valid()) {
@@ -48,6 +48,7 @@
 
 #include "utils.h"
 #include "hooks.h"
+#include "times.h"
 
 namespace ledger {
 
@@ -59,6 +60,7 @@ class xact_finalizer_t;
 class period_xact_t;
 class account_t;
 class scope_t;
+class mask_t;
 
 typedef std::list<xact_t *>	   xacts_list;
 typedef std::list<auto_xact_t *>   auto_xacts_list;
@@ -81,7 +83,96 @@ public:
 
   hooks_t<xact_finalizer_t, xact_t> xact_finalize_hooks;
 
-  journal_t(account_t * _master = NULL) : master(_master) {
+  // This index orders xacts by the earliest date among their postings,
+  // each paired with its position in `xacts'.  `spread' is the most days
+  // by which any xact's latest posting follows its earliest one.  It is
+  // built the first time xacts_in_range is called, and rebuilt only if
+  // xacts are added or removed, or --effective changes what a posting's
+  // date means.
+  struct date_index_t
+  {
+    struct entry_t {
+      date_t	  earliest;
+      std::size_t position;
+      xact_t *	  xact;
+
+      bool operator<(const entry_t& other) const {
+	return earliest < other.earliest;
+      }
+    };
+
+    std::vector<entry_t> entries;
+    long		 spread;
+    std::size_t		 last_size;
+    bool		 effective;
+
+    date_index_t() : spread(0), last_size(0), effective(false) {
+      TRACE_CTOR(journal_t::date_index_t, "");
+    }
+    date_index_t(const date_index_t& other)
+      : entries(other.entries), spread(other.spread),
+	last_size(other.last_size), effective(other.effective) {
+      TRACE_CTOR(journal_t::date_index_t, "copy");
+    }
+    ~date_index_t() throw() {
+      TRACE_DTOR(journal_t::date_index_t);
+    }
+  };
+
+  optional<date_index_t> date_index_;
+
+  // This index maps each distinct payee to its xacts, in journal order,
+  // so that a payee mask need only be matched once against each payee.
+  // It is built the first time it is needed, and kept current after
+  // that by add_xact and remove_xact.
+  typedef std::map<string, std::vector<xact_t *> > payee_index_t;
+
+  optional<payee_index_t> payee_index_;
+
+  // This index maps each tag name, and each pair of tag name and value,
+  // to the xacts in which the xact itself or any of its postings has
+  // that tag, in journal order.  Since every tag is set while an xact
+  // is parsed, before it is added, it is built and kept current just as
+  // the payee index is.
+  struct tag_index_t
+  {
+    typedef std::map<string, std::vector<xact_t *> > names_map;
+    typedef std::map<std::pair<string, string>,
+		     std::vector<xact_t *> >	      values_map;
+
+    names_map  names;
+    values_map values;
+
+    tag_index_t() {
+      TRACE_CTOR(journal_t::tag_index_t, "");
+    }
+    tag_index_t(const tag_index_t& other)
+      : names(other.names), values(other.values) {
+      TRACE_CTOR(journal_t::tag_index_t, "copy");
+    }
+    ~tag_index_t() throw() {
+      TRACE_DTOR(journal_t::tag_index_t);
+    }
+
+    void add_xact(xact_t * xact);
+    void remove_xact(xact_t * xact);
+  };
+
+  optional<tag_index_t> tag_index_;
+
+  // How many xacts have ever been added, which gives each xact its
+  // sequence number.  Unlike a position in `xacts', this never changes
+  // once assigned, even as other xacts are removed.
+  std::size_t xacts_added;
+
+  // How many balance reports have asked for account totals over a range
+  // of dates.  Building the date index of every account costs more than
+  // one walk of the journal, so the indices are built only once a second
+  // such report suggests they will be used again.
+  std::size_t date_range_queries;
+
+  journal_t(account_t * _master = NULL)
+    : master(_master), xacts_added(0), date_range_queries(0) {
     TRACE_CTOR(journal_t, "");
   }
   ~journal_t();
@@ -96,6 +187,26 @@ public:
   bool add_xact(xact_t * xact);
   bool remove_xact(xact_t * xact);
 
+  // Remove XACT's postings from the accounts they refer to.
+  void unhook_posts(xact_t& xact);
+
+  const date_index_t& date_index();
+
+  // Set RESULT to those xacts, in journal order, which have at least one
+  // posting dated on or after BEGIN and before END.  A few others may be
+  // included as well, which have postings on both sides of the range.
+  void xacts_in_range(const optional<date_t>& begin,
+		      const optional<date_t>& end,
+		      std::vector<xact_t *>&  result);
+
+  const payee_index_t& payee_index();
+  const tag_index_t&   tag_index();
+
+  // Return the most recent xact whose payee MASK matches, or NULL.
+  xact_t * last_xact_with_payee(const mask_t& mask);
+
+  static bool earlier_xact(const xact_t * left, const xact_t * right);
+
   void add_xact_finalizer(xact_finalizer_t * finalizer) {
     xact_finalize_hooks.add_hook(finalizer);
   }
@@ -73,6 +73,7 @@ int main(int argc, char * argv[], char * envp[])
   //   --verbose           ; turns on logging
   //   --debug CATEGORY    ; turns on debug logging
   //   --trace LEVEL       ; turns on trace logging
+  //   --profile-exprs     ; turns on value expression profiling
   handle_debug_options(argc, argv);
 #if defined(VERIFY_ON)
   IF_VERIFY() initialize_memory_tracing();
@@ -203,6 +204,11 @@ int main(int argc, char * argv[], char * envp[])
 				// if help text (such as --help) was displayed
   }
 
+#if defined(PROFILE_ON)
+  if (expr_profiling_enabled)
+    report_expr_profile(std::cerr);
+#endif
+
   // If memory verification is being performed (which can be very slow), clean
   // up everything by closing the session and deleting the session object, and
   // then shutting down the memory tracing subsystem.  Otherwise, let it all
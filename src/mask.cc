@@ -35,7 +35,8 @@
 
 namespace ledger {
 
-mask_t::mask_t(const string& pat) : expr()
+mask_t::mask_t(const string& pat)
+  : expr(), is_literal(false), is_anchored(false)
 {
   TRACE_CTOR(mask_t, "const string&");
   *this = pat;
@@ -44,8 +45,142 @@ mask_t::mask_t(const string& pat) : expr()
 mask_t& mask_t::operator=(const string& pat)
 {
   expr.assign(pat.c_str(), regex::perl | regex::icase);
+  analyze(pat);
   VERIFY(valid());
   return *this;
 }
 
+namespace {
+  // Only ASCII letters are folded, and the same way whatever the locale,
+  // so a pattern and the strings it is matched against are always folded
+  // alike.
+  inline char fold_case(const char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+  }
+}
+
+void mask_t::analyze(const string& pat)
+{
+  literals.clear();
+  is_literal  = false;
+  is_anchored = false;
+
+  literal_t lit;
+
+  for (const char * p = pat.c_str(); ; p++) {
+    switch (*p) {
+    case '\0':
+    case '|':
+      literals.push_back(lit);
+      if (*p == '\0') {
+	is_literal = true;
+	return;
+      }
+      lit = literal_t();
+      break;
+
+    case '^':
+      if (! lit.text.empty() || lit.at_begin)
+	goto not_literal;
+      lit.at_begin = is_anchored = true;
+      break;
+
+    case '$':
+      if (*(p + 1) != '\0' && *(p + 1) != '|')
+	goto not_literal;
+      lit.at_end = is_anchored = true;
+      break;
+
+    case '\\':
+      // Only these escapes stand for the character itself.  Anything
+      // else (\d, \b, \Q, and also \< \> \` \', which Boost treats as
+      // word and buffer assertions) needs the regex engine.
+      p++;
+      if (*p == '\0' || ! std::strchr(".:-/\\()[]{}*+?|^$", *p))
+	goto not_literal;
+      lit.text += *p;
+      break;
+
+    case '.': case '*': case '+': case '?':
+    case '(': case ')': case '[': case ']': case '{': case '}':
+      goto not_literal;
+
+    default:
+      // Case-folding of non-ASCII characters is locale-dependent, so
+      // only patterns made of plain ASCII are handled here.
+      if (static_cast<unsigned char>(*p) >= 0x80)
+	goto not_literal;
+      lit.text += fold_case(*p);
+      break;
+    }
+  }
+
+ not_literal:
+  literals.clear();
+  is_anchored = false;
+}
+
+namespace {
+  bool equals_folded(const char * str, const string& lower)
+  {
+    for (string::const_iterator i = lower.begin(); i != lower.end(); i++)
+      if (fold_case(*str++) != *i)
+	return false;
+    return true;
+  }
+
+  bool contains_folded(const string& str, const string& lower)
+  {
+    if (lower.empty())
+      return true;
+    if (lower.length() > str.length())
+      return false;
+
+    const char * p   = str.data();
+    const char * end = p + (str.length() - lower.length()) + 1;
+    const char	 c   = lower[0];
+
+    if (c < 'a' || c > 'z') {
+      // The first character has no other case, so let memchr find each
+      // candidate position.
+      while (p < end) {
+	p = static_cast<const char *>(std::memchr(p, c, end - p));
+	if (! p)
+	  break;
+	if (equals_folded(p, lower))
+	  return true;
+	p++;
+      }
+    } else {
+      const char C = static_cast<char>(c - 'a' + 'A');
+      for (; p < end; p++)
+	if ((*p == c || *p == C) && equals_folded(p, lower))
+	  return true;
+    }
+    return false;
+  }
+}
+
+bool mask_t::match_literals(const string& str) const
+{
+  foreach (const literal_t& lit, literals) {
+    const std::size_t len = lit.text.length();
+
+    if (lit.at_begin) {
+      if (lit.at_end ? len == str.length() : len <= str.length())
+	if (equals_folded(str.data(), lit.text))
+	  return true;
+    }
+    else if (lit.at_end) {
+      if (len <= str.length() &&
+	  equals_folded(str.data() + (str.length() - len), lit.text))
+	return true;
+    }
+    else if (contains_folded(str, lit.text)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 } // namespace ledger
@@ -49,21 +49,43 @@
 namespace ledger {
 
 /**
- * @brief Brief
+ * @brief A case-insensitive regular expression used to select items.
  *
- * Long.
+ * Nearly all masks given on the command-line or in expressions are plain
+ * words, possibly anchored with ^ or $, or a few such words joined with
+ * |.  When a pattern is of that form, its alternatives are kept as
+ * lowercased literals and matched directly, without running the regex
+ * engine.  The compiled regex is always kept as well, since it defines
+ * the semantics and is used whenever the fast path cannot be trusted.
  */
 class mask_t
 {
 public:
   boost::regex expr;
 
+  struct literal_t
+  {
+    string text;		// lowercased
+    bool   at_begin;
+    bool   at_end;
+
+    literal_t() : at_begin(false), at_end(false) {}
+  };
+
+  typedef std::vector<literal_t> literals_t;
+
+  literals_t literals;
+  bool	     is_literal;
+  bool	     is_anchored;
+
   explicit mask_t(const string& pattern);
 
-  mask_t() : expr() {
+  mask_t() : expr(), is_literal(false), is_anchored(false) {
     TRACE_CTOR(mask_t, "");
   }
-  mask_t(const mask_t& m) : expr(m.expr) {
+  mask_t(const mask_t& m)
+    : expr(m.expr), literals(m.literals),
+      is_literal(m.is_literal), is_anchored(m.is_anchored) {
     TRACE_CTOR(mask_t, "copy");
   }
   ~mask_t() throw() {
@@ -80,6 +102,11 @@ public:
     DEBUG("mask.match",
 	  "Matching: \"" << str << "\" =~ /" << expr.str() << "/ = "
 	  << (boost::regex_search(str, expr) ? "true" : "false"));
+    // ^ and $ also match around embedded line separators, which the
+    // literal matcher does not model; leave those cases to the regex.
+    if (is_literal && (! is_anchored ||
+		       str.find_first_of("\n\r\f") == string::npos))
+      return match_literals(str);
     return boost::regex_search(str, expr);
   }
 
@@ -92,8 +119,16 @@ public:
       DEBUG("ledger.validate", "mask_t: expr.status() != 0");
       return false;
     }
+    if (is_literal && literals.empty()) {
+      DEBUG("ledger.validate", "mask_t: is_literal && literals.empty()");
+      return false;
+    }
     return true;
   }
+
+private:
+  void analyze(const string& pattern);
+  bool match_literals(const string& str) const;
 };
 
 inline std::ostream& operator<<(std::ostream& out, const mask_t& mask) {
@@ -95,10 +95,77 @@ expr_t::ptr_op_t expr_t::op_t::compile(scope_t& scope)
   return intermediate;
 }
 
+#if defined(PROFILE_ON)
+
+bool expr_profiling_enabled = false;
+
+namespace {
+  struct op_profile_t
+  {
+    std::size_t	  calls;
+    time_duration spent;
+
+    op_profile_t() : calls(0), spent(0, 0, 0, 0) {}
+  };
+
+  typedef std::map<const expr_t::op_t *, op_profile_t> op_profile_map;
+  typedef std::map<string, op_profile_t>		   name_profile_map;
+  typedef std::pair<expr_t::ptr_op_t, string>		   profiled_expr_t;
+
+  op_profile_map		     op_profiles;
+  name_profile_map		     name_profiles;
+  std::list<profiled_expr_t>	     profiled_exprs;
+  std::set<const expr_t::op_t *> profiled_roots;
+
+  // Records the time from construction to destruction against OP, so that
+  // calls which end in an exception are counted as well.
+  class op_profile_sentry_t
+  {
+    const expr_t::op_t * op;
+    ptime		 begin;
+
+  public:
+    explicit op_profile_sentry_t(const expr_t::op_t * _op)
+      : op(expr_profiling_enabled ? _op : NULL) {
+      if (op)
+	begin = posix_time::microsec_clock::universal_time();
+    }
+    ~op_profile_sentry_t() {
+      if (! op)
+	return;
+
+      time_duration spent =
+	posix_time::microsec_clock::universal_time() - begin;
+
+      op_profile_t& node(op_profiles[op]);
+      node.calls++;
+      node.spent += spent;
+
+      const string * name = NULL;
+      if (op->kind == expr_t::op_t::IDENT)
+	name = &op->as_ident();
+      else if (op->kind == expr_t::op_t::O_CALL && op->left()->is_ident())
+	name = &op->left()->as_ident();
+
+      if (name) {
+	op_profile_t& func(name_profiles[*name]);
+	func.calls++;
+	func.spent += spent;
+      }
+    }
+  };
+}
+
+#endif // PROFILE_ON
+
 value_t expr_t::op_t::calc(scope_t& scope, ptr_op_t * locus)
 {
   try {
 
+#if defined(PROFILE_ON)
+  op_profile_sentry_t profile_sentry(this);
+#endif
+
   value_t result;
 
   DEBUG("expr.calc", "calculating '" << op_context(this) << "'");
@@ -611,62 +678,69 @@ bool expr_t::op_t::print(std::ostream& out, const context_t& context) const
   return found;
 }
 
-void expr_t::op_t::dump(std::ostream& out, const int depth) const
-{
-  out.setf(std::ios::left);
-  out.width(10);
-  out << this;
+namespace {
+  void dump_op_kind(std::ostream& out, const expr_t::op_t& op)
+  {
+    switch (op.kind) {
+    case expr_t::op_t::VALUE:
+      out << "VALUE: ";
+      op.as_value().dump(out);
+      break;
 
-  for (int i = 0; i < depth; i++)
-    out << " ";
+    case expr_t::op_t::IDENT:
+      out << "IDENT: " << op.as_ident();
+      break;
 
-  switch (kind) {
-  case VALUE:
-    out << "VALUE: ";
-    as_value().dump(out);
-    break;
+    case expr_t::op_t::FUNCTION:
+      out << "FUNCTION";
+      break;
 
-  case IDENT:
-    out << "IDENT: " << as_ident();
-    break;
+    case expr_t::op_t::O_DEFINE: out << "O_DEFINE"; break;
+    case expr_t::op_t::O_LOOKUP: out << "O_LOOKUP"; break;
+    case expr_t::op_t::O_CALL:   out << "O_CALL"; break;
+    case expr_t::op_t::O_MATCH:  out << "O_MATCH"; break;
 
-  case FUNCTION:
-    out << "FUNCTION";
-    break;
+    case expr_t::op_t::O_NOT:    out << "O_NOT"; break;
+    case expr_t::op_t::O_NEG:    out << "O_NEG"; break;
+
+    case expr_t::op_t::O_ADD:    out << "O_ADD"; break;
+    case expr_t::op_t::O_SUB:    out << "O_SUB"; break;
+    case expr_t::op_t::O_MUL:    out << "O_MUL"; break;
+    case expr_t::op_t::O_DIV:    out << "O_DIV"; break;
 
-  case O_DEFINE: out << "O_DEFINE"; break;
-  case O_LOOKUP: out << "O_LOOKUP"; break;
-  case O_CALL:	 out << "O_CALL"; break;
-  case O_MATCH:	 out << "O_MATCH"; break;
+    case expr_t::op_t::O_EQ:     out << "O_EQ"; break;
+    case expr_t::op_t::O_LT:     out << "O_LT"; break;
+    case expr_t::op_t::O_LTE:    out << "O_LTE"; break;
+    case expr_t::op_t::O_GT:     out << "O_GT"; break;
+    case expr_t::op_t::O_GTE:    out << "O_GTE"; break;
 
-  case O_NOT:	 out << "O_NOT"; break;
-  case O_NEG:	 out << "O_NEG"; break;
+    case expr_t::op_t::O_AND:    out << "O_AND"; break;
+    case expr_t::op_t::O_OR:     out << "O_OR"; break;
 
-  case O_ADD:	 out << "O_ADD"; break;
-  case O_SUB:	 out << "O_SUB"; break;
-  case O_MUL:	 out << "O_MUL"; break;
-  case O_DIV:	 out << "O_DIV"; break;
+    case expr_t::op_t::O_QUERY:  out << "O_QUERY"; break;
+    case expr_t::op_t::O_COLON:  out << "O_COLON"; break;
 
-  case O_EQ:	 out << "O_EQ"; break;
-  case O_LT:	 out << "O_LT"; break;
-  case O_LTE:	 out << "O_LTE"; break;
-  case O_GT:	 out << "O_GT"; break;
-  case O_GTE:	 out << "O_GTE"; break;
+    case expr_t::op_t::O_CONS:   out << "O_CONS"; break;
+    case expr_t::op_t::O_SEQ:    out << "O_SEQ"; break;
 
-  case O_AND:	 out << "O_AND"; break;
-  case O_OR:	 out << "O_OR"; break;
+    case expr_t::op_t::LAST:
+    default:
+      assert(false);
+      break;
+    }
+  }
+}
 
-  case O_QUERY:  out << "O_QUERY"; break;
-  case O_COLON:	 out << "O_COLON"; break;
+void expr_t::op_t::dump(std::ostream& out, const int depth) const
+{
+  out.setf(std::ios::left);
+  out.width(10);
+  out << this;
 
-  case O_CONS:	 out << "O_CONS"; break;
-  case O_SEQ:	 out << "O_SEQ"; break;
+  for (int i = 0; i < depth; i++)
+    out << " ";
 
-  case LAST:
-  default:
-    assert(false);
-    break;
-  }
+  dump_op_kind(out, *this);
 
   out << " (" << refc << ')' << std::endl;
 
@@ -703,4 +777,89 @@ string op_context(const expr_t::ptr_op_t op,
   return buf.str();
 }
 
+#if defined(PROFILE_ON)
+
+void profile_expr(const expr_t::ptr_op_t& op, const string& text)
+{
+  if (profiled_roots.insert(op.get()).second)
+    profiled_exprs.push_back(profiled_expr_t(op, text));
+}
+
+namespace {
+  time_duration profiled_time(const expr_t::ptr_op_t& op)
+  {
+    op_profile_map::const_iterator i = op_profiles.find(op.get());
+    return i == op_profiles.end() ? time_duration(0, 0, 0, 0) : (*i).second.spent;
+  }
+
+  // Like op_t::dump, but shows the calls and cumulative time of each node
+  // in place of its reference count.  A node is marked as hot when the time
+  // spent in it, less that of its operands, is a tenth or more of the time
+  // spent in the whole expression.
+  void dump_op_profile(std::ostream& out, const expr_t::ptr_op_t& op,
+		       const int depth, const time_duration& whole)
+  {
+    out.setf(std::ios::left);
+    out.width(10);
+    out << op.get();
+
+    for (int i = 0; i < depth; i++)
+      out << " ";
+
+    dump_op_kind(out, *op);
+
+    bool has_operands = op->kind > expr_t::op_t::TERMINALS || op->is_ident();
+    bool has_right    = (has_operands && op->left() &&
+			 op->kind > expr_t::op_t::UNARY_OPERATORS &&
+			 op->has_right());
+
+    op_profile_map::const_iterator i = op_profiles.find(op.get());
+    if (i == op_profiles.end()) {
+      out << " (never evaluated)";
+    } else {
+      const op_profile_t& node((*i).second);
+      out << " (" << node.calls << " calls, "
+	  << node.spent.total_microseconds() << " us)";
+
+      time_duration own = node.spent;
+      if (has_operands && op->left()) {
+	own -= profiled_time(op->left());
+	if (has_right)
+	  own -= profiled_time(op->right());
+      }
+      if (whole.total_microseconds() > 0 &&
+	  own.total_microseconds() * 10 >= whole.total_microseconds())
+	out << " <== hot";
+    }
+    out << std::endl;
+
+    if (has_operands && op->left()) {
+      dump_op_profile(out, op->left(), depth + 1, whole);
+      if (has_right)
+	dump_op_profile(out, op->right(), depth + 1, whole);
+    }
+  }
+}
+
+void report_expr_profile(std::ostream& out)
+{
+  foreach (const profiled_expr_t& pair, profiled_exprs) {
+    out << "Expression: " << pair.second << std::endl;
+    dump_op_profile(out, pair.first, 0, profiled_time(pair.first));
+    out << std::endl;
+  }
+
+  if (! name_profiles.empty()) {
+    out << "Functions:" << std::endl;
+    foreach (const name_profile_map::value_type& pair, name_profiles) {
+      out << "  ";
+      out.width(30);
+      out << pair.first << ' ' << pair.second.calls << " calls, "
+	  << pair.second.spent.total_microseconds() << " us" << std::endl;
+    }
+  }
+}
+
+#endif // PROFILE_ON
+
 } // namespace ledger
@@ -317,6 +317,28 @@ inline expr_t::ptr_op_t expr_t::op_t::wrap_functor(const function_t& fobj) {
 string op_context(const expr_t::ptr_op_t op,
 		  const expr_t::ptr_op_t locus = NULL);
 
+#if defined(PROFILE_ON)
+
+/**
+ * @name Expression profiling
+ *
+ * When --profile-exprs is given, every call to op_t::calc records a call
+ * count and the cumulative time spent in that node, and in the function or
+ * identifier it names.  report_expr_profile prints each expression that was
+ * evaluated as an annotated tree, marking the nodes where most of the time
+ * was spent.
+ */
+/*@{*/
+
+extern bool expr_profiling_enabled;
+
+void profile_expr(const expr_t::ptr_op_t& op, const string& text);
+void report_expr_profile(std::ostream& out);
+
+/*@}*/
+
+#endif // PROFILE_ON
+
 } // namespace ledger
 
 #endif // _OP_H
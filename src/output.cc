@@ -37,6 +37,7 @@
 #include "account.h"
 #include "session.h"
 #include "report.h"
+#include "unistring.h"
 
 namespace ledger {
 
@@ -224,4 +225,204 @@ void format_accounts::operator()(account_t& account)
   posted_accounts.push_back(&account);
 }
 
+format_pivot::format_pivot(report_t& _report) : report(_report), depth(0)
+{
+  TRACE_CTOR(format_pivot, "report&");
+
+  // report_t::pivot_command sees that a period is always given.
+  interval.parse(report.HANDLER(period_).str());
+  if (! interval.duration)
+    throw_(std::logic_error,
+	   _("The pivot report needs a period with a duration, such as --monthly"));
+
+  if (report.HANDLED(depth_))
+    depth = static_cast<unsigned short>
+      (report.HANDLER(depth_).value.to_long());
+}
+
+void format_pivot::operator()(post_t& post)
+{
+  // Postings need not arrive in date order (--sort and --by-payee both
+  // reorder them), so each goes to the column for its own period start.
+  date_t date = post.date();
+  columns.insert(date);
+
+  // interval_posts reports empty periods against an account of its own,
+  // which has no parent.  The period still gets its column.
+  account_t * acct = post.reported_account();
+  if (! acct->parent)
+    return;
+
+  if (depth > 0)
+    while (acct->depth > depth && acct->parent->parent)
+      acct = acct->parent;
+
+  post.add_to_value(rows[acct][date]);
+}
+
+void format_pivot::add_cells(cells_t& to, const cells_t& from)
+{
+  foreach (const cells_t::value_type& pair, from)
+    add_or_set_value(to[pair.first], pair.second);
+}
+
+void format_pivot::mark_rows(account_t& account, const rows_map& family,
+			     std::vector<account_t *>& shown)
+{
+  // As in format_accounts::mark_accounts, a parent with no postings of
+  // its own is shown only if more than one of its children is, since
+  // otherwise its row would just repeat that child's.
+  std::size_t position = shown.size();
+  shown.push_back(&account);
+
+  std::size_t children = 0;
+  foreach (accounts_map::value_type& pair, account.accounts)
+    if (family.find(pair.second) != family.end()) {
+      mark_rows(*pair.second, family, shown);
+      children++;
+    }
+
+  if (children == 1 && rows.find(&account) == rows.end())
+    shown.erase(shown.begin() + position);
+}
+
+void format_pivot::flush()
+{
+  std::ostream& out(report.output_stream);
+
+  if (columns.empty()) {
+    out.flush();
+    return;
+  }
+
+  // Columns are in ascending order, so find_period never has to go back.
+  std::vector<optional<datetime_t> > moments;
+  if (report.HANDLED(market)) {
+    foreach (const date_t& start, columns) {
+      if (interval.find_period(start) && interval.inclusive_end())
+	moments.push_back(datetime_t(*interval.inclusive_end(),
+				     time_duration_t(23, 59, 59)));
+      else
+	moments.push_back(none);
+    }
+  }
+
+  // With --flat, each account with postings is a row showing only its
+  // own.  Otherwise every account's cells are added to all of its
+  // parents, and the rows follow the account tree.
+  rows_map		   family;
+  std::vector<account_t *> shown;
+
+  if (report.HANDLED(flat)) {
+    foreach (rows_map::value_type& pair, rows)
+      shown.push_back(pair.first);
+  } else {
+    foreach (rows_map::value_type& pair, rows)
+      for (account_t * acct = pair.first; acct->parent; acct = acct->parent)
+	add_cells(family[acct], pair.second);
+
+    accounts_map roots;
+    foreach (rows_map::value_type& pair, family)
+      if (! pair.first->parent->parent)
+	roots.insert(accounts_map::value_type(pair.first->name, pair.first));
+
+    foreach (accounts_map::value_type& pair, roots)
+      mark_rows(*pair.second, family, shown);
+  }
+
+  typedef std::pair<string, const cells_t *> row_t;
+
+  std::vector<row_t> sorted;
+  sorted.reserve(shown.size());
+  foreach (account_t * acct, shown)
+    sorted.push_back(row_t(acct->fullname(),
+			   report.HANDLED(flat) ? &rows[acct] : &family[acct]));
+  if (report.HANDLED(flat))
+    std::sort(sorted.begin(), sorted.end());
+
+  // Render every cell before printing anything, so that the width of
+  // each column is known.  A cell holding several commodities takes
+  // several lines.
+  typedef std::vector<string> lines_t;
+
+  std::vector<string>		    headers;
+  std::vector<std::size_t>	    widths;
+  std::vector<std::vector<lines_t> > text(sorted.size());
+  std::size_t			    account_width = 0;
+
+  foreach (const date_t& start, columns) {
+    headers.push_back(format_date(start));
+    widths.push_back(unistring(headers.back()).length());
+  }
+
+  for (std::size_t r = 0; r < sorted.size(); r++) {
+    account_width = std::max(account_width,
+			     unistring(sorted[r].first).length());
+
+    const cells_t& cells(*sorted[r].second);
+    text[r].resize(columns.size());
+
+    value_t	running;
+    std::size_t c = 0;
+    for (std::set<date_t>::const_iterator i = columns.begin();
+	 i != columns.end();
+	 i++, c++) {
+      value_t			shown;
+      cells_t::const_iterator cell = cells.find(*i);
+      if (cell != cells.end())
+	shown = cell->second;
+
+      if (report.HANDLED(cumulative)) {
+	if (! shown.is_null())
+	  add_or_set_value(running, shown);
+	shown = running;
+      }
+      if (shown.is_null())
+	continue;
+
+      if (! moments.empty() && moments[c]) {
+	value_t valued(shown.value(true, *moments[c]));
+	if (! valued.is_null())
+	  shown = valued;
+      }
+
+      std::ostringstream buf;
+      shown.strip_annotations(report.what_to_keep()).print(buf);
+
+      std::istringstream lines(buf.str());
+      string line;
+      while (std::getline(lines, line)) {
+	text[r][c].push_back(line);
+	widths[c] = std::max(widths[c], unistring(line).length());
+      }
+    }
+  }
+
+  justify(out, "", static_cast<int>(account_width));
+  for (std::size_t c = 0; c < columns.size(); c++) {
+    out << "  ";
+    justify(out, headers[c], static_cast<int>(widths[c]), true);
+  }
+  out << '\n';
+
+  for (std::size_t r = 0; r < sorted.size(); r++) {
+    std::size_t height = 1;
+    foreach (const lines_t& lines, text[r])
+      height = std::max(height, lines.size());
+
+    for (std::size_t l = 0; l < height; l++) {
+      justify(out, l == 0 ? sorted[r].first : string(),
+	      static_cast<int>(account_width));
+      for (std::size_t c = 0; c < columns.size(); c++) {
+	out << "  ";
+	justify(out, l < text[r][c].size() ? text[r][c][l] : string(),
+		static_cast<int>(widths[c]), true);
+      }
+      out << '\n';
+    }
+  }
+
+  out.flush();
+}
+
 } // namespace ledger
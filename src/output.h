@@ -115,6 +115,46 @@ public:
   virtual void operator()(account_t& account);
 };
 
+/**
+ * @brief Prints a table of account balances by period.
+ *
+ * Each row is an account, and each column one of the periods produced
+ * by interval_posts, so that a whole (account x period) matrix comes
+ * from a single pass over the postings.  Postings may arrive in any
+ * order; each is added to the cell for its account and period start.
+ * As with format_accounts, a parent account's row shows the total of
+ * its whole family, --depth folds deeper accounts into their ancestor
+ * at that depth, and --flat lists only accounts with postings of their
+ * own.  With --cumulative, each cell shows the running balance up to the
+ * end of its period rather than the change during it; with --market,
+ * cells are valued as of the last day of their period.
+ */
+class format_pivot : public item_handler<post_t>
+{
+protected:
+  typedef std::map<date_t, value_t>	  cells_t;
+  typedef std::map<account_t *, cells_t> rows_map;
+
+  report_t&	      report;
+  date_interval_t     interval;
+  std::set<date_t>    columns;
+  rows_map	      rows;
+  unsigned short      depth;
+
+  void add_cells(cells_t& to, const cells_t& from);
+  void mark_rows(account_t& account, const rows_map& family,
+		 std::vector<account_t *>& shown);
+
+public:
+  format_pivot(report_t& _report);
+  virtual ~format_pivot() {
+    TRACE_DTOR(format_pivot);
+  }
+
+  virtual void flush();
+  virtual void operator()(post_t& post);
+};
+
 } // namespace ledger
 
 #endif // _OUTPUT_H
@@ -40,6 +40,11 @@
 
 namespace ledger {
 
+post_t::xdata_arena_t	post_t::xdata_arena;
+std::vector<post_t::xdata_t *> post_t::xdata_unused;
+std::size_t		post_t::xdata_generation = 0;
+bool			post_t::xdata_in_use	 = false;
+
 bool post_t::has_tag(const string& tag) const
 {
   if (item_t::has_tag(tag))
@@ -80,7 +85,7 @@ optional<string> post_t::get_tag(const mask_t& tag_mask,
 
 date_t post_t::date() const
 {
-  if (xdata_ && is_valid(xdata_->date))
+  if (has_xdata() && is_valid(xdata_->date))
     return xdata_->date;
 
   if (item_t::use_effective_date) {
@@ -142,10 +147,7 @@ namespace {
   }
 
   value_t get_amount(post_t& post) {
-    if (post.has_xdata() && post.xdata().has_flags(POST_EXT_COMPOUND))
-      return post.xdata().compound_value;
-    else
-      return post.amount;
+    return post.amount_value();
   }
 
   value_t get_use_direct_amount(post_t& post) {
@@ -175,14 +177,11 @@ namespace {
   }
 
   value_t get_total(post_t& post) {
-    if (post.xdata_ && ! post.xdata_->total.is_null())
-      return post.xdata_->total;
-    else
-      return post.amount;
+    return post.total_value();
   }
 
   value_t get_count(post_t& post) {
-    if (post.xdata_)
+    if (post.has_xdata())
       return long(post.xdata_->count);
     else
       return 1L;
@@ -376,7 +375,7 @@ bool post_t::valid() const
 
 void post_t::add_to_value(value_t& value, const optional<expr_t&>& expr) const
 {
-  if (xdata_ && xdata_->has_flags(POST_EXT_COMPOUND)) {
+  if (has_xdata() && xdata_->has_flags(POST_EXT_COMPOUND)) {
     add_or_set_value(value, xdata_->compound_value);
   }
   else if (expr) {
@@ -386,14 +385,14 @@ void post_t::add_to_value(value_t& value, const optional<expr_t&>& expr) const
     value_t temp(expr->calc(bound_scope));
     add_or_set_value(value, temp);
 #else
-    if (! xdata_) xdata_ = xdata_t();
+    const_cast<post_t *>(this)->xdata();
     xdata_->value = expr->calc(bound_scope);
     xdata_->add_flags(POST_EXT_COMPOUND);
 
     add_or_set_value(value, xdata_->value);
 #endif
   }
-  else if (xdata_ && xdata_->has_flags(POST_EXT_VISITED) &&
+  else if (has_xdata() && xdata_->has_flags(POST_EXT_VISITED) &&
 	   ! xdata_->visited_value.is_null()) {
     add_or_set_value(value, xdata_->visited_value);
   }
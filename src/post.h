@@ -71,12 +71,11 @@ public:
 
   amount_t	     amount;	// can be null until finalization
   optional<amount_t> cost;
-  optional<amount_t> assigned_amount;
 
   post_t(account_t * _account = NULL,
 	 flags_t     _flags   = ITEM_NORMAL)
     : item_t(_flags),
-      xact(NULL), account(_account)
+      xact(NULL), account(_account), xdata_(NULL), xdata_stamp_(0)
   {
     TRACE_CTOR(post_t, "account_t *, flags_t");
   }
@@ -85,7 +84,8 @@ public:
 	 flags_t                 _flags = ITEM_NORMAL,
 	 const optional<string>& _note = none)
     : item_t(_flags, _note),
-      xact(NULL), account(_account), amount(_amount)
+      xact(NULL), account(_account), amount(_amount),
+      xdata_(NULL), xdata_stamp_(0)
   {
     TRACE_CTOR(post_t, "account_t *, const amount_t&, flags_t, const optional<string>&");
   }
@@ -95,15 +95,25 @@ public:
       account(post.account),
       amount(post.amount),
       cost(post.cost),
-      assigned_amount(post.assigned_amount),
-      xdata_(post.xdata_)
+      xdata_(NULL), xdata_stamp_(0)
   {
+    if (post.has_xdata())
+      xdata() = xdata_t(*post.xdata_);
     TRACE_CTOR(post_t, "copy");
   }
   ~post_t() {
     TRACE_DTOR(post_t);
   }
 
+  // A journal holds a great many postings, so they are allocated in
+  // slabs; see slab_allocator_t.
+  static void * operator new(std::size_t size) {
+    return slab_allocator_t<post_t>::allocate(size);
+  }
+  static void operator delete(void * ptr, std::size_t size) {
+    slab_allocator_t<post_t>::release(ptr, size);
+  }
+
   virtual bool has_tag(const string& tag) const;
   virtual bool has_tag(const mask_t& tag_mask,
 		       const optional<mask_t>& value_mask = none) const;
@@ -169,21 +179,69 @@ public:
     }
   };
 
-  // This variable holds optional "extended data" which is usually produced
-  // only during reporting, and only for the posting set being reported.
-  // It's a memory-saving measure to delay allocation until the last possible
-  // moment.
-  mutable optional<xdata_t> xdata_;
+  // This variable points to optional "extended data" which is usually
+  // produced only during reporting, and only for the posting set being
+  // reported.  It lives in xdata_arena rather than in the posting, so
+  // that a posting which no report touches pays only for this pointer.
+  mutable xdata_t * xdata_;
+  mutable std::size_t xdata_stamp_;
+
+  // The extended data of every posting is allocated from this arena, and
+  // is all discarded at once by clear_xdata_arena when a report is done.
+  // Doing so advances the generation number, and a posting whose
+  // xdata_stamp_ is older than it is treated as having no extended data;
+  // its stale pointer is never followed.  A record given up early by
+  // clear_xdata is kept in xdata_unused and handed out again.
+  //
+  // There is only the one arena, so only one report may use it at a time.
+  // report_t holds an xdata_user_t while it walks postings, and neither a
+  // second user nor clear_xdata_arena is allowed while one is held.
+  typedef std::deque<xdata_t> xdata_arena_t;
+
+  static xdata_arena_t	       xdata_arena;
+  static std::vector<xdata_t *> xdata_unused;
+  static std::size_t	       xdata_generation;
+  static bool		       xdata_in_use;
+
+  struct xdata_user_t
+  {
+    xdata_user_t() {
+      assert(! xdata_in_use);
+      xdata_in_use = true;
+    }
+    ~xdata_user_t() {
+      xdata_in_use = false;
+    }
+  };
+
+  static void clear_xdata_arena() {
+    assert(! xdata_in_use);
+    ++xdata_generation;
+    xdata_unused.clear();
+    xdata_arena.clear();
+  }
 
   bool has_xdata() const {
-    return xdata_;
+    return xdata_ && xdata_stamp_ == xdata_generation;
   }
   void clear_xdata() {
-    xdata_ = none;
+    if (has_xdata()) {
+      *xdata_ = xdata_t();
+      xdata_unused.push_back(xdata_);
+    }
+    xdata_ = NULL;
   }
   xdata_t& xdata() {
-    if (! xdata_)
-      xdata_ = xdata_t();
+    if (! has_xdata()) {
+      if (xdata_unused.empty()) {
+	xdata_arena.push_back(xdata_t());
+	xdata_ = &xdata_arena.back();
+      } else {
+	xdata_ = xdata_unused.back();
+	xdata_unused.pop_back();
+      }
+      xdata_stamp_ = xdata_generation;
+    }
     return *xdata_;
   }
   const xdata_t& xdata() const {
@@ -193,8 +251,23 @@ public:
   void add_to_value(value_t& value,
 		    const optional<expr_t&>& expr = none) const;
 
+  // The values of "amount" and "total" for this posting, computed directly
+  // rather than through a value expression.
+  value_t amount_value() const {
+    if (has_xdata() && xdata_->has_flags(POST_EXT_COMPOUND))
+      return xdata_->compound_value;
+    else
+      return amount;
+  }
+  value_t total_value() const {
+    if (has_xdata() && ! xdata_->total.is_null())
+      return xdata_->total;
+    else
+      return amount;
+  }
+
   account_t * reported_account() {
-    if (xdata_)
+    if (has_xdata())
       if (account_t * acct = xdata_->account)
 	return acct;
     return account;
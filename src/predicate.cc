@@ -32,9 +32,442 @@
 #include <system.hh>
 
 #include "predicate.h"
+#include "op.h"
+#include "account.h"
+#include "journal.h"
+#include "xact.h"
 
 namespace ledger {
 
+namespace {
+  typedef expr_t::ptr_op_t ptr_op_t;
+  typedef expr_t::op_t	   op_t;
+
+  // Identifiers which simply read a field of the item, its transaction or
+  // its account.  Anything else may compute amounts, totals or values.
+  const char * cheap_identifiers[] = {
+    "account", "account_base", "actual", "cleared", "code", "d", "date",
+    "depth", "effective_date", "has_meta", "has_tag", "meta", "note",
+    "payee", "pending", "real", "status", "tag", "uncleared", "virtual",
+    NULL
+  };
+
+  bool is_cheap_identifier(const string& name)
+  {
+    for (const char ** p = cheap_identifiers; *p; p++)
+      if (name == *p)
+	return true;
+    return false;
+  }
+
+  bool has_side_effects(const ptr_op_t& op)
+  {
+    if (! op || op->kind < op_t::TERMINALS)
+      return false;
+    if (op->kind == op_t::O_DEFINE || op->kind == op_t::O_SEQ)
+      return true;
+    return (has_side_effects(op->left()) ||
+	    (op->kind > op_t::UNARY_OPERATORS && op->has_right() &&
+	     has_side_effects(op->right())));
+  }
+
+  std::size_t estimated_cost(const ptr_op_t& op)
+  {
+    if (! op)
+      return 0;
+
+    switch (op->kind) {
+    case op_t::VALUE:
+      return 0;
+    case op_t::IDENT:
+      return is_cheap_identifier(op->as_ident()) ? 1 : 10;
+    case op_t::FUNCTION:
+      return 10;
+
+    case op_t::O_CALL:
+      return (estimated_cost(op->left()) +
+	      (op->has_right() ? estimated_cost(op->right()) : 0));
+    case op_t::O_MATCH:
+      return 2 + estimated_cost(op->left()) + estimated_cost(op->right());
+
+    default:
+      if (op->kind < op_t::TERMINALS)
+	return 1;
+      return (estimated_cost(op->left()) +
+	      (op->kind > op_t::UNARY_OPERATORS && op->has_right() ?
+	       estimated_cost(op->right()) : 0));
+    }
+  }
+
+  void flatten_conjunction(const ptr_op_t&	  op,
+			   std::vector<ptr_op_t>& terms,
+			   std::vector<ptr_op_t>& ands)
+  {
+    if (op->kind == op_t::O_AND) {
+      flatten_conjunction(op->left(), terms, ands);
+      flatten_conjunction(op->right(), terms, ands);
+      ands.push_back(op);
+    } else {
+      terms.push_back(op);
+    }
+  }
+
+  bool cheaper_term(const std::pair<std::size_t, ptr_op_t>& left,
+		    const std::pair<std::size_t, ptr_op_t>& right)
+  {
+    return left.first < right.first;
+  }
+
+  void order_by_cost(const ptr_op_t& op)
+  {
+    if (! op || op->kind < op_t::TERMINALS || op->kind == op_t::O_DEFINE)
+      return;
+
+    if (op->kind != op_t::O_AND) {
+      order_by_cost(op->left());
+      if (op->kind > op_t::UNARY_OPERATORS && op->has_right())
+	order_by_cost(op->right());
+      return;
+    }
+
+    std::vector<ptr_op_t> terms;
+    std::vector<ptr_op_t> ands;
+    flatten_conjunction(op, terms, ands);
+
+    std::vector<std::pair<std::size_t, ptr_op_t> > costed;
+    foreach (ptr_op_t& term, terms) {
+      if (has_side_effects(term))
+	return;
+      order_by_cost(term);
+      costed.push_back(std::pair<std::size_t, ptr_op_t>
+		       (estimated_cost(term), term));
+    }
+    std::stable_sort(costed.begin(), costed.end(), cheaper_term);
+
+    // Relink the existing & nodes as a left-leaning chain over the sorted
+    // terms.  The last node in ANDS is OP itself, so the root is kept.
+    ptr_op_t chain = costed[0].second;
+    for (std::size_t i = 1; i < costed.size(); i++) {
+      ands[i - 1]->set_left(chain);
+      ands[i - 1]->set_right(costed[i].second);
+      chain = ands[i - 1];
+    }
+    assert(chain == op);
+  }
+
+  // Narrow BEGIN and END by OP, if it compares `date' with a fixed date.
+  bool narrow_date_range(const ptr_op_t&   op,
+			 optional<date_t>& begin,
+			 optional<date_t>& end)
+  {
+    if (op->kind != op_t::O_LT && op->kind != op_t::O_LTE &&
+	op->kind != op_t::O_GT && op->kind != op_t::O_GTE)
+      return false;
+
+    // Accept both `date < [X]' and `[X] > date', by flipping the latter.
+    op_t::kind_t kind = op->kind;
+    ptr_op_t	 ident = op->left();
+    ptr_op_t	 value = op->right();
+    if (ident->kind == op_t::VALUE) {
+      std::swap(ident, value);
+      switch (kind) {
+      case op_t::O_LT:  kind = op_t::O_GT;  break;
+      case op_t::O_LTE: kind = op_t::O_GTE; break;
+      case op_t::O_GT:  kind = op_t::O_LT;  break;
+      default:		kind = op_t::O_LTE; break;
+      }
+    }
+
+    if (! (ident->kind == op_t::IDENT && ident->as_ident() == "date" &&
+	   value->kind == op_t::VALUE && value->as_value().is_date()))
+      return false;
+
+    date_t when = value->as_value().as_date();
+    switch (kind) {
+    case op_t::O_GT:
+      when += gregorian::days(1);
+      // fall through...
+    case op_t::O_GTE:
+      if (! begin || when > *begin)
+	begin = when;
+      break;
+
+    case op_t::O_LTE:
+      when += gregorian::days(1);
+      // fall through...
+    default:
+      if (! end || when < *end)
+	end = when;
+      break;
+    }
+    return true;
+  }
+
+  // Narrow BEGIN and END by every date comparison among the terms of the
+  // conjunction OP, and count the terms which are not one.
+  bool narrow_by_conjuncts(const ptr_op_t&   op,
+			   optional<date_t>& begin,
+			   optional<date_t>& end,
+			   std::size_t&	     other_terms)
+  {
+    if (op->kind == op_t::O_AND) {
+      bool left	 = narrow_by_conjuncts(op->left(), begin, end, other_terms);
+      bool right = narrow_by_conjuncts(op->right(), begin, end, other_terms);
+      return left || right;
+    }
+    if (narrow_date_range(op, begin, end))
+      return true;
+
+    ++other_terms;
+    return false;
+  }
+
+  // Whether OP is `IDENT =~ /X/', or a disjunction of such terms.
+  bool is_match_term(const ptr_op_t& op, const char * ident)
+  {
+    if (op->kind == op_t::O_OR)
+      return (is_match_term(op->left(), ident) &&
+	      is_match_term(op->right(), ident));
+
+    return (op->kind == op_t::O_MATCH &&
+	    op->left()->kind == op_t::IDENT &&
+	    op->left()->as_ident() == ident &&
+	    op->right()->kind == op_t::VALUE &&
+	    op->right()->as_value().is_mask());
+  }
+
+  bool match_term_matches(const ptr_op_t& op, const string& str)
+  {
+    if (op->kind == op_t::O_OR)
+      return (match_term_matches(op->left(), str) ||
+	      match_term_matches(op->right(), str));
+
+    return op->right()->as_value().as_mask().match(str);
+  }
+
+  bool all_terms_match(const std::vector<ptr_op_t>& terms, const string& str)
+  {
+    foreach (const ptr_op_t& term, terms)
+      if (! match_term_matches(term, str))
+	return false;
+    return true;
+  }
+
+  // Gather those terms of the conjunction OP which match IDENT.
+  void find_match_terms(const ptr_op_t&	       op,
+			const char *	       ident,
+			std::vector<ptr_op_t>& terms)
+  {
+    if (op->kind == op_t::O_AND) {
+      find_match_terms(op->left(), ident, terms);
+      find_match_terms(op->right(), ident, terms);
+    }
+    else if (is_match_term(op, ident)) {
+      terms.push_back(op);
+    }
+  }
+
+  bool is_pattern(const ptr_op_t& op)
+  {
+    return (op && op->kind == op_t::VALUE &&
+	    (op->as_value().is_string() || op->as_value().is_mask()));
+  }
+
+  // Whether OP is `has_tag(X)' or `has_tag(X, Y)', for fixed strings or
+  // masks X and Y.
+  bool is_tag_term(const ptr_op_t& op)
+  {
+    if (! (op->kind == op_t::O_CALL &&
+	   op->left()->kind == op_t::IDENT &&
+	   (op->left()->as_ident() == "has_tag" ||
+	    op->left()->as_ident() == "has_meta") &&
+	   op->has_right()))
+      return false;
+
+    ptr_op_t args = op->right();
+    if (args->kind == op_t::O_CONS)
+      return (is_pattern(args->left()) &&
+	      args->has_right() && is_pattern(args->right()));
+
+    return is_pattern(args);
+  }
+
+  void find_tag_terms(const ptr_op_t& op, std::vector<ptr_op_t>& terms)
+  {
+    if (op->kind == op_t::O_AND) {
+      find_tag_terms(op->left(), terms);
+      find_tag_terms(op->right(), terms);
+    }
+    else if (is_tag_term(op)) {
+      terms.push_back(op);
+    }
+  }
+
+  // Set XACTS to those xacts in JOURNAL, in journal order, which may
+  // hold a posting that the tag term OP accepts.
+  void find_tagged_xacts(const ptr_op_t&	op,
+			 journal_t&		journal,
+			 std::vector<xact_t *>& xacts)
+  {
+    typedef journal_t::tag_index_t tag_index_t;
+
+    const tag_index_t& index(journal.tag_index());
+    ptr_op_t	       args = op->right();
+
+    xacts.clear();
+    if (args->kind == op_t::O_CONS) {
+      mask_t tag_mask(args->left()->as_value().to_mask());
+      mask_t value_mask(args->right()->as_value().to_mask());
+
+      foreach (const tag_index_t::values_map::value_type& pair, index.values)
+	if (tag_mask.match(pair.first.first) &&
+	    value_mask.match(pair.first.second))
+	  xacts.insert(xacts.end(), pair.second.begin(), pair.second.end());
+    }
+    else if (args->as_value().is_string()) {
+      tag_index_t::names_map::const_iterator i =
+	index.names.find(args->as_value().as_string());
+      if (i != index.names.end())
+	xacts = i->second;
+      return;
+    }
+    else {
+      const mask_t& tag_mask(args->as_value().as_mask());
+
+      foreach (const tag_index_t::names_map::value_type& pair, index.names)
+	if (tag_mask.match(pair.first))
+	  xacts.insert(xacts.end(), pair.second.begin(), pair.second.end());
+    }
+
+    std::sort(xacts.begin(), xacts.end(), journal_t::earlier_xact);
+    xacts.erase(std::unique(xacts.begin(), xacts.end()), xacts.end());
+  }
+
+  // A posting's `account' is its account's full name, wrapped in (...)
+  // or [...] if the posting is virtual.  Any of these might be matched.
+  bool account_may_match(const account_t&	      account,
+			 const std::vector<ptr_op_t>& terms)
+  {
+    string fullname = account.fullname();
+    string names[3] = {
+      fullname, string("(") + fullname + ")", string("[") + fullname + "]"
+    };
+
+    for (int i = 0; i < 3; i++)
+      if (all_terms_match(terms, names[i]))
+	return true;
+    return false;
+  }
+
+  void find_matching_accounts(account_t&		   account,
+			      const std::vector<ptr_op_t>& terms,
+			      std::vector<account_t *>&	   accounts)
+  {
+    if (! account.posts.empty() && account_may_match(account, terms))
+      accounts.push_back(&account);
+
+    foreach (accounts_map::value_type& pair, account.accounts)
+      find_matching_accounts(*pair.second, terms, accounts);
+  }
+}
+
+void order_predicate_by_cost(expr_t& expr)
+{
+  if (expr)
+    order_by_cost(expr.get_op());
+}
+
+bool predicate_date_range(const expr_t&	   expr,
+			  optional<date_t>& begin,
+			  optional<date_t>& end)
+{
+  optional<date_t> low;
+  optional<date_t> high;
+  std::size_t	   other_terms = 0;
+  if (! expr || ! narrow_by_conjuncts(expr.get_op(), low, high, other_terms) ||
+      other_terms > 0)
+    return false;
+
+  begin = low;
+  end	= high;
+  return true;
+}
+
+bool predicate_date_bounds(const expr_t&     expr,
+			   optional<date_t>& begin,
+			   optional<date_t>& end)
+{
+  optional<date_t> low;
+  optional<date_t> high;
+  std::size_t	   other_terms = 0;
+  if (! expr || ! narrow_by_conjuncts(expr.get_op(), low, high, other_terms))
+    return false;
+
+  begin = low;
+  end	= high;
+  return true;
+}
+
+bool predicate_accounts(const expr_t&		  expr,
+			account_t&		  master,
+			std::vector<account_t *>& accounts)
+{
+  std::vector<ptr_op_t> terms;
+  if (expr)
+    find_match_terms(expr.get_op(), "account", terms);
+  if (terms.empty())
+    return false;
+
+  accounts.clear();
+  find_matching_accounts(master, terms, accounts);
+  return true;
+}
+
+bool predicate_payees(const expr_t&	      expr,
+		      journal_t&	      journal,
+		      std::vector<xact_t *>& xacts)
+{
+  std::vector<ptr_op_t> terms;
+  if (expr)
+    find_match_terms(expr.get_op(), "payee", terms);
+  if (terms.empty())
+    return false;
+
+  xacts.clear();
+  foreach (const journal_t::payee_index_t::value_type& pair,
+	   journal.payee_index())
+    if (all_terms_match(terms, pair.first))
+      xacts.insert(xacts.end(), pair.second.begin(), pair.second.end());
+
+  std::sort(xacts.begin(), xacts.end(), journal_t::earlier_xact);
+  return true;
+}
+
+bool predicate_tags(const expr_t&	    expr,
+		    journal_t&		    journal,
+		    std::vector<xact_t *>& xacts)
+{
+  std::vector<ptr_op_t> terms;
+  if (expr)
+    find_tag_terms(expr.get_op(), terms);
+  if (terms.empty())
+    return false;
+
+  find_tagged_xacts(terms[0], journal, xacts);
+
+  for (std::size_t i = 1; i < terms.size() && ! xacts.empty(); i++) {
+    std::vector<xact_t *> tagged;
+    find_tagged_xacts(terms[i], journal, tagged);
+
+    std::vector<xact_t *> both;
+    std::set_intersection(xacts.begin(), xacts.end(),
+			  tagged.begin(), tagged.end(),
+			  std::back_inserter(both), journal_t::earlier_xact);
+    xacts.swap(both);
+  }
+  return true;
+}
+
 string args_to_predicate_expr(value_t::sequence_t::const_iterator& begin,
 			      value_t::sequence_t::const_iterator end)
 {
@@ -52,6 +52,72 @@
 
 namespace ledger {
 
+class account_t;
+class journal_t;
+class xact_t;
+
+/**
+ * Reorder the terms of every conjunction in EXPR so that those which
+ * only consult cheap properties of an item (its date, account, payee or
+ * state) are tested before those which must compute amounts or values.
+ * Since & short-circuits, items rejected by a cheap term never pay for
+ * the expensive ones.  Conjunctions with side-effects are left alone.
+ */
+void order_predicate_by_cost(expr_t& expr);
+
+/**
+ * If EXPR is nothing but a conjunction of comparisons between `date' and
+ * fixed dates, such as --begin and --end produce, set BEGIN and END to
+ * the first date it accepts and the first date past it that it rejects,
+ * and return true.  Either is left unset if that side is unbounded.
+ */
+bool predicate_date_range(const expr_t&	   expr,
+			  optional<date_t>& begin,
+			  optional<date_t>& end);
+
+/**
+ * Like predicate_date_range, but EXPR need only be a conjunction of which
+ * some terms compare `date' with fixed dates.  Every item EXPR accepts
+ * then lies within BEGIN and END, though not every item within them is
+ * accepted.
+ */
+bool predicate_date_bounds(const expr_t&     expr,
+			   optional<date_t>& begin,
+			   optional<date_t>& end);
+
+/**
+ * If EXPR is a conjunction of which some terms match `account' against
+ * fixed masks, as the account arguments of a query do, set ACCOUNTS to
+ * every account under MASTER holding postings that those terms could
+ * accept, and return true.  Any posting EXPR accepts then belongs to one
+ * of ACCOUNTS.
+ */
+bool predicate_accounts(const expr_t&		  expr,
+			account_t&		  master,
+			std::vector<account_t *>& accounts);
+
+/**
+ * If EXPR is a conjunction of which some terms match `payee' against
+ * fixed masks, set XACTS to every xact in JOURNAL, in journal order,
+ * whose payee all of those terms accept, and return true.  Any posting
+ * EXPR accepts then belongs to one of XACTS.
+ */
+bool predicate_payees(const expr_t&	      expr,
+		      journal_t&	      journal,
+		      std::vector<xact_t *>& xacts);
+
+/**
+ * If EXPR is a conjunction of which some terms call `has_tag' with fixed
+ * tag names or masks, such as `%tag' and `%tag=value' query arguments
+ * produce, set XACTS to every xact in JOURNAL, in journal order, which
+ * has tags that all of those terms could accept, whether on the xact or
+ * on one of its postings.  Any posting EXPR accepts then belongs to one
+ * of XACTS.
+ */
+bool predicate_tags(const expr_t&	    expr,
+		    journal_t&		    journal,
+		    std::vector<xact_t *>& xacts);
+
 /**
  * @brief Brief
  *
@@ -79,6 +145,7 @@ public:
 		 const keep_details_t& _what_to_keep)
     : predicate(expr_t(_predicate)), what_to_keep(_what_to_keep) {
     TRACE_CTOR(item_predicate, "const string&, const keep_details_t&");
+    order_predicate_by_cost(predicate);
   }
   ~item_predicate() throw() {
     TRACE_DTOR(item_predicate);
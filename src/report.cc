@@ -46,10 +46,73 @@
 
 namespace ledger {
 
+namespace {
+  // If PREDICATE can only accept postings of xacts with certain payees
+  // or tags, walk just those xacts; or if it can only accept postings
+  // made to certain accounts, walk just those accounts' postings; or if
+  // it can only accept postings within a range of dates, walk just the
+  // xacts which may hold such postings.  PREDICATE itself is still applied to
+  // each of them, by the caller.  PAYEES_FIXED or ACCOUNTS_FIXED is false
+  // when a posting's payee or account may be changed before PREDICATE
+  // sees it.
+  posts_iterator * journal_walker(journal_t&	journal,
+				  const expr_t& predicate,
+				  bool		payees_fixed   = true,
+				  bool		accounts_fixed = true)
+  {
+    std::vector<xact_t *> xacts;
+    if (payees_fixed && predicate_payees(predicate, journal, xacts)) {
+      DEBUG("report.predicate", "Walking only the " << xacts.size()
+	    << " xacts with matching payees");
+      return new selected_posts_iterator(xacts);
+    }
+    if (predicate_tags(predicate, journal, xacts)) {
+      DEBUG("report.predicate", "Walking only the " << xacts.size()
+	    << " xacts with matching tags");
+      return new selected_posts_iterator(xacts);
+    }
+
+    std::vector<account_t *> accounts;
+    if (accounts_fixed &&
+	predicate_accounts(predicate, *journal.master, accounts)) {
+      DEBUG("report.predicate", "Walking only the postings of "
+	    << accounts.size() << " accounts");
+      return new account_posts_iterator(journal, accounts);
+    }
+
+    optional<date_t> begin;
+    optional<date_t> end;
+    if (predicate_date_bounds(predicate, begin, end)) {
+      DEBUG("report.predicate", "Walking only the xacts from "
+	    << (begin ? format_date(*begin) : string("the start")) << " to "
+	    << (end ? format_date(*end) : string("the end")));
+      return new dated_posts_iterator(journal, begin, end);
+    }
+    return new journal_posts_iterator(journal);
+  }
+
+  posts_iterator * journal_walker(report_t& report)
+  {
+    return journal_walker(*report.session.journal.get(),
+			  report.HANDLED(limit_) ?
+			  expr_t(report.HANDLER(limit_).str()) : expr_t(),
+			  ! (report.HANDLED(set_payee_) ||
+			     report.HANDLED(comm_as_payee) ||
+			     report.HANDLED(code_as_payee)),
+			  ! (report.HANDLED(set_account_) ||
+			     report.HANDLED(payee_as_account) ||
+			     report.HANDLED(comm_as_account) ||
+			     report.HANDLED(code_as_account)));
+  }
+}
+
 void report_t::posts_report(post_handler_ptr handler)
 {
-  journal_posts_iterator walker(*session.journal.get());
-  pass_down_posts(chain_post_handlers(*this, handler), walker);
+  {
+    post_t::xdata_user_t xdata_user;
+    scoped_ptr<posts_iterator> walker(journal_walker(*this));
+    pass_down_posts(chain_post_handlers(*this, handler), *walker.get());
+  }
   session.clean_posts();
 }
 
@@ -58,6 +121,7 @@ void report_t::generate_report(post_handler_ptr handler)
   // jww (2009-02-27): make this more general
   HANDLER(limit_).on(string("#generate"), "actual");
 
+  post_t::xdata_user_t xdata_user;
   generate_posts_iterator walker
     (session, HANDLED(seed_) ?
      static_cast<unsigned int>(HANDLER(seed_).value.to_long()) : 0,
@@ -69,59 +133,239 @@ void report_t::generate_report(post_handler_ptr handler)
 
 void report_t::xact_report(post_handler_ptr handler, xact_t& xact)
 {
-  xact_posts_iterator walker(xact);
-  pass_down_posts(chain_post_handlers(*this, handler), walker);
+  {
+    post_t::xdata_user_t xdata_user;
+    xact_posts_iterator walker(xact);
+    pass_down_posts(chain_post_handlers(*this, handler), walker);
+  }
   session.clean_posts(xact);
 }
 
 void report_t::accounts_report(acct_handler_ptr handler)
 {
-  journal_posts_iterator walker(*session.journal.get());
-  pass_down_posts(chain_post_handlers(*this, post_handler_ptr(new ignore_posts),
-				      true), walker);
+  {
+    post_t::xdata_user_t xdata_user;
 
-  scoped_ptr<accounts_iterator> iter;
-  if (! HANDLED(sort_))
-    iter.reset(new basic_accounts_iterator(*session.master));
-  else
-    iter.reset(new sorted_accounts_iterator(HANDLER(sort_).str(),
-					    HANDLED(flat), *session.master.get()));
+    if (! accumulate_accounts()) {
+      scoped_ptr<posts_iterator> walker(journal_walker(*this));
+      pass_down_posts(chain_post_handlers(*this,
+					  post_handler_ptr(new ignore_posts),
+					  true), *walker.get());
+    }
 
-  if (HANDLED(display_))
-    pass_down_accounts(handler, *iter.get(),
-		       item_predicate(HANDLER(display_).str(), what_to_keep()),
-		       *this);
-  else
-    pass_down_accounts(handler, *iter.get());
+    scoped_ptr<accounts_iterator> iter;
+    if (! HANDLED(sort_))
+      iter.reset(new basic_accounts_iterator(*session.master));
+    else
+      iter.reset(new sorted_accounts_iterator(HANDLER(sort_).str(),
+					      HANDLED(flat),
+					      *session.master.get()));
+
+    if (HANDLED(display_))
+      pass_down_accounts(handler, *iter.get(),
+			 item_predicate(HANDLER(display_).str(),
+					what_to_keep()), *this);
+    else
+      pass_down_accounts(handler, *iter.get());
+  }
 
   session.clean_posts();
   session.clean_accounts();
 }
 
+namespace {
+  bool date_indices_current(const account_t& account)
+  {
+    if (! account.posts.empty() && ! account.has_date_index())
+      return false;
+
+    foreach (const accounts_map::value_type& pair, account.accounts)
+      if (! date_indices_current(*pair.second))
+	return false;
+    return true;
+  }
+
+  void accumulate_accounts_by_date(account_t&		   account,
+				   const optional<date_t>& begin,
+				   const optional<date_t>& end)
+  {
+    foreach (accounts_map::value_type& pair, account.accounts)
+      accumulate_accounts_by_date(*pair.second, begin, end);
+
+    if (account.posts.empty())
+      return;
+
+    value_t total(account.self_total(begin, end));
+    if (! total.is_null()) {
+      account_t::xdata_t& xdata(account.xdata());
+      xdata.add_flags(ACCOUNT_EXT_VISITED);
+      xdata.self_details.total	   = total;
+      xdata.self_details.last_size = account.posts.size();
+    }
+  }
+}
+
+bool report_t::accumulate_accounts()
+{
+  // For a balance report, chain_post_handlers places nothing but the
+  // --limit and --only filters in front of calc_posts, unless one of
+  // these options is used.  Each of them can create, drop or reassign
+  // postings, and so needs the full chain.
+  if (HANDLED(dow) || HANDLED(by_payee) || HANDLED(period_) ||
+      HANDLED(related) || HANDLED(anon) ||
+      budget_flags != BUDGET_NO_BUDGET || HANDLED(forecast_while_) ||
+      HANDLED(set_account_) || HANDLED(set_payee_) ||
+      HANDLED(comm_as_payee) || HANDLED(code_as_payee) ||
+      HANDLED(payee_as_account) || HANDLED(comm_as_account) ||
+      HANDLED(code_as_account))
+    return false;
+
+  DEBUG("report.accounts", "Accumulating account totals directly");
+
+  assert(HANDLED(amount_));
+  expr_t& amount_expr(HANDLER(amount_).expr);
+  amount_expr.set_context(this);
+  bool native_amount = amount_expr.text() == "amount";
+
+  // The two filters are tested as one predicate, just as they are by the
+  // chain when nothing stands between them.
+  item_predicate predicate;
+  if (HANDLED(limit_) && HANDLED(only_))
+    predicate = item_predicate(string("(") + HANDLER(limit_).str() + ")&(" +
+			       HANDLER(only_).str() + ")", what_to_keep());
+  else if (HANDLED(limit_))
+    predicate = item_predicate(HANDLER(limit_).str(), what_to_keep());
+  else if (HANDLED(only_))
+    predicate = item_predicate(HANDLER(only_).str(), what_to_keep());
+
+  // When --limit does no more than select a range of dates, as --begin
+  // and --end do, each account's total can be read from its date index.
+  // A single such report is quicker to walk, though, so the indices are
+  // built only for the second one, or used if they are already current.
+  optional<date_t> begin;
+  optional<date_t> end;
+  if (native_amount && HANDLED(limit_) && ! HANDLED(only_) &&
+      predicate_date_range(predicate.predicate, begin, end) &&
+      (session.journal->date_range_queries++ > 0 ||
+       date_indices_current(*session.master))) {
+    DEBUG("report.accounts", "Reading account totals from date indices");
+    accumulate_accounts_by_date(*session.master, begin, end);
+    return true;
+  }
+
+  bool filtered = HANDLED(limit_) || HANDLED(only_);
+
+  // This does the work of calc_posts, and then of account_t::self_total,
+  // in a single pass: each matching posting is added to its account's
+  // total as it is visited, and marked as considered so that self_total
+  // will not count it a second time.
+  std::list<account_t *> visited;
+  std::size_t		 count = 0;
+
+  scoped_ptr<posts_iterator> walker(journal_walker(*session.journal.get(),
+						   predicate.predicate));
+  for (post_t * post = (*walker)(); post; post = (*walker)()) {
+    try {
+      bind_scope_t bound_scope(*this, *post);
+      if (! predicate(bound_scope))
+	continue;
+
+      post_t::xdata_t& xdata(post->xdata());
+      if (filtered)
+	xdata.add_flags(POST_EXT_MATCHES);
+
+      xdata.count = ++count;
+      if (native_amount)
+	add_or_set_value(xdata.visited_value, post->amount_value());
+      else
+	post->add_to_value(xdata.visited_value, amount_expr);
+      xdata.add_flags(POST_EXT_VISITED);
+
+      account_t *	   acct = post->reported_account();
+      account_t::xdata_t& acct_xdata(acct->xdata());
+      if (! acct_xdata.has_flags(ACCOUNT_EXT_VISITED)) {
+	acct_xdata.add_flags(ACCOUNT_EXT_VISITED);
+	visited.push_back(acct);
+      }
+
+      post->add_to_value(acct_xdata.self_details.total);
+      xdata.add_flags(POST_EXT_CONSIDERED);
+    }
+    catch (const std::exception& err) {
+      add_error_context(item_context(*post, _("While handling posting")));
+      throw;
+    }
+  }
+
+  foreach (account_t * acct, visited)
+    acct->xdata().self_details.last_size = acct->posts.size();
+
+  return true;
+}
+
 void report_t::commodities_report(post_handler_ptr handler)
 {
-  posts_commodities_iterator walker(*session.journal.get());
-  pass_down_posts(chain_post_handlers(*this, handler), walker);
+  {
+    post_t::xdata_user_t xdata_user;
+    posts_commodities_iterator walker(*session.journal.get());
+    pass_down_posts(chain_post_handlers(*this, handler), walker);
+  }
   session.clean_posts();
 }
 
+namespace {
+  // Find the scope against which an unqualified "amount" or "total" would
+  // be resolved from SCOPE.  Only call and bind scopes are looked through,
+  // since neither can define those names themselves.
+  scope_t * innermost_item(scope_t * scope)
+  {
+    while (scope) {
+      if (bind_scope_t * bound = dynamic_cast<bind_scope_t *>(scope))
+	scope = &bound->grandchild;
+      else if (call_scope_t * call = dynamic_cast<call_scope_t *>(scope))
+	scope = call->parent;
+      else
+	break;
+    }
+    return scope;
+  }
+}
+
 value_t report_t::fn_amount_expr(call_scope_t& scope)
 {
+  if (HANDLER(amount_).is_default) {
+    scope_t * item = innermost_item(&scope);
+    if (post_t * post = dynamic_cast<post_t *>(item))
+      return post->amount_value();
+    else if (account_t * account = dynamic_cast<account_t *>(item))
+      return VALUE_OR_ZERO(account->self_total());
+  }
   return HANDLER(amount_).expr.calc(scope);
 }
 
 value_t report_t::fn_total_expr(call_scope_t& scope)
 {
+  if (HANDLER(total_).is_default) {
+    scope_t * item = innermost_item(&scope);
+    if (post_t * post = dynamic_cast<post_t *>(item))
+      return post->total_value();
+    else if (account_t * account = dynamic_cast<account_t *>(item))
+      return VALUE_OR_ZERO(account->family_total());
+  }
   return HANDLER(total_).expr.calc(scope);
 }
 
 value_t report_t::fn_display_amount(call_scope_t& scope)
 {
+  if (HANDLER(display_amount_).is_default)
+    return fn_amount_expr(scope);
   return HANDLER(display_amount_).expr.calc(scope);
 }
 
 value_t report_t::fn_display_total(call_scope_t& scope)
 {
+  if (HANDLER(display_total_).is_default)
+    return fn_total_expr(scope);
   return HANDLER(display_total_).expr.calc(scope);
 }
 
@@ -405,6 +649,26 @@ value_t report_t::reload_command(call_scope_t&)
   return true;
 }
 
+value_t report_t::pivot_command(call_scope_t& args)
+{
+  // Every column is a period, so monthly periods are used unless some
+  // other period was asked for.
+  if (! HANDLED(period_))
+    HANDLER(period_).on(string("#pivot"), "monthly");
+
+  // format_pivot values each cell as of the end of its period, so the
+  // revaluation postings that --market and --basis turn on are not
+  // wanted.  Asking for them directly cannot be honoured here.
+  if (HANDLED(revalued)) {
+    if (! HANDLED(market) && ! HANDLED(basis))
+      throw_(std::logic_error,
+	     _("The pivot report cannot be used with --revalued or --gain"));
+    HANDLER(revalued).off();
+  }
+
+  return reporter<>(new format_pivot(*this), *this, "#pivot")(args);
+}
+
 bool report_t::maybe_import(const string& module)
 {
   if (lookup(string(OPT_PREFIX) + "import_")) {
@@ -515,6 +779,7 @@ option_t<report_t> * report_t::lookup_option(const char * p)
     else OPT(collapse_if_zero);
     else OPT(color);
     else OPT(columns_);
+    else OPT(cumulative);
     else OPT_ALT(basis, cost);
     else OPT_(current);
     break;
@@ -724,6 +989,8 @@ expr_t::ptr_op_t report_t::lookup(const string& name)
 	    (reporter<post_t, post_handler_ptr, &report_t::commodities_report>
 	     (new format_posts(*this, report_format(HANDLER(pricesdb_format_))),
 	      *this, "#pricesdb"));
+	else if (is_eq(q, "pivot"))
+	  return MAKE_FUNCTOR(report_t::pivot_command);
 	else if (is_eq(q, "python") && maybe_import("ledger.interp"))
 	  return session.lookup(string(CMD_PREFIX) + "python");
 	break;
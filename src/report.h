@@ -138,6 +138,14 @@ public:
   void accounts_report(acct_handler_ptr handler);
   void commodities_report(post_handler_ptr handler);
 
+  /**
+   * Sum the postings chosen by the report predicates straight into
+   * their accounts' totals, without going through the posting handler
+   * chain.  Returns false, having done nothing, if any option is active
+   * which needs the full chain.
+   */
+  bool accumulate_accounts();
+
   value_t fn_amount_expr(call_scope_t& scope);
   value_t fn_total_expr(call_scope_t& scope);
   value_t fn_display_amount(call_scope_t& scope);
@@ -178,6 +186,7 @@ public:
   }
 
   value_t reload_command(call_scope_t&);
+  value_t pivot_command(call_scope_t& args);
 
   keep_details_t what_to_keep() {
     bool lots = HANDLED(lots) || HANDLED(lots_actual);
@@ -215,6 +224,7 @@ public:
     HANDLER(collapse_if_zero).report(out);
     HANDLER(columns_).report(out);
     HANDLER(csv_format_).report(out);
+    HANDLER(cumulative).report(out);
     HANDLER(current).report(out);
     HANDLER(daily).report(out);
     HANDLER(date_format_).report(out);
@@ -318,11 +328,13 @@ public:
   OPTION__
   (report_t, amount_, // -t
    expr_t expr;
+   bool   is_default;
    CTOR(report_t, amount_) {
      set_expr(none, "amount");
    }
    void set_expr(const optional<string>& whence, const string& str) {
-     expr = str;
+     expr       = str;
+     is_default = str == "amount";
      on(whence, str);
    }
    DO_(args) {
@@ -404,6 +416,8 @@ public:
 	 "%(quoted(join(note | xact.note)))\n");
     });
 
+  OPTION(report_t, cumulative);
+
   OPTION_(report_t, current, DO() { // -c
       parent->HANDLER(limit_).on(string("--current"), "date<=today");
     });
@@ -417,11 +431,10 @@ public:
 	     on(none, "%y-%b-%d");
 	   });
 
-  OPTION_(report_t, depth_, DO_(scope) {
-      interactive_t args(scope, "sl");
-      parent->HANDLER(display_).on(string("--depth"),
-				   string("depth<=") + args.get<string>(1));
-    });
+  // --depth becomes part of the display predicate in
+  // global_scope_t::normalize_report_options, except for the pivot report,
+  // which rolls deeper accounts up into their parents itself.
+  OPTION(report_t, depth_);
 
   OPTION_(report_t, deviation, DO() { // -D
       parent->HANDLER(display_total_)
@@ -443,11 +456,13 @@ public:
   OPTION__
   (report_t, display_amount_,
    expr_t expr;
+   bool   is_default;
    CTOR(report_t, display_amount_) {
      set_expr(none, "amount_expr");
    }
    void set_expr(const optional<string>& whence, const string& str) {
-     expr = str;
+     expr       = str;
+     is_default = str == "amount_expr";
      on(whence, str);
    }
    DO_(args) {
@@ -457,11 +472,13 @@ public:
   OPTION__
   (report_t, display_total_,
    expr_t expr;
+   bool   is_default;
    CTOR(report_t, display_total_) {
      set_expr(none, "total_expr");
    }
    void set_expr(const optional<string>& whence, const string& str) {
-     expr = str;
+     expr       = str;
+     is_default = str == "total_expr";
      on(whence, str);
    }
    DO_(args) {
@@ -743,11 +760,13 @@ public:
   OPTION__
   (report_t, total_, // -T
    expr_t expr;
+   bool   is_default;
    CTOR(report_t, total_) {
      set_expr(none, "total");
    }
    void set_expr(const optional<string>& whence, const string& str) {
-     expr = str;
+     expr       = str;
+     is_default = str == "total";
      on(whence, str);
    }
    DO_(args) {
@@ -191,7 +191,16 @@ void session_t::close_journal_files()
   master.reset();
   commodity_pool.reset();
   amount_t::shutdown();
-  
+
+  // With the journal gone, the slabs its objects were carved from can be
+  // given back, unless something (a Python reference, say) still holds
+  // one of those objects.  Values are used everywhere, not just by the
+  // journal, so their slabs are kept.
+  post_t::clear_xdata_arena();
+  slab_allocator_t<post_t>::release_all();
+  slab_allocator_t<xact_t>::release_all();
+  slab_allocator_t<account_t>::release_all();
+
   commodity_pool.reset(new commodity_pool_t);
   amount_t::initialize(commodity_pool);
   master.reset(new account_t);
@@ -200,8 +209,8 @@ void session_t::close_journal_files()
 
 void session_t::clean_posts()
 {
-  journal_posts_iterator walker(*journal.get());
-  pass_down_posts(post_handler_ptr(new clear_post_xdata), walker);
+  // Rather than visit every posting, discard all of their xdata at once.
+  post_t::clear_xdata_arena();
 }
 
 void session_t::clean_posts(xact_t& xact)
@@ -212,9 +221,7 @@ void session_t::clean_posts(xact_t& xact)
 
 void session_t::clean_accounts()
 {
-  basic_accounts_iterator acct_walker(*master);
-  pass_down_accounts(acct_handler_ptr(new clear_account_xdata), acct_walker);
-  master->clear_xdata();
+  ++account_t::xdata_generation;
 }
 
 option_t<session_t> * session_t::lookup_option(const char * p)
@@ -69,6 +69,7 @@ namespace {
     bool              strict;
 
     path	      pathname;
+    uint_least32_t    source_file;
     char	      linebuf[MAX_LINE + 1];
     std::size_t       linenum;
     istream_pos_type  line_beg_pos;
@@ -207,6 +208,8 @@ instance_t::instance_t(std::list<account_t *>& _account_stack,
     pathname = *_original_file;
   else
     pathname = "/dev/stdin";
+
+  source_file = item_t::add_source_file(pathname);
 }
 
 instance_t::~instance_t()
@@ -515,7 +518,7 @@ void instance_t::automated_xact_directive(char * line)
 
     journal.auto_xacts.push_back(ae.get());
 
-    ae->pathname = pathname;
+    ae->source_file = source_file;
     ae->beg_pos  = pos;
     ae->beg_line = lnum;
     ae->end_pos  = curr_pos;
@@ -555,7 +558,7 @@ void instance_t::period_xact_directive(char * line)
 
       journal.period_xacts.push_back(pe.get());
 
-      pe->pathname = pathname;
+      pe->source_file = source_file;
       pe->beg_pos  = pos;
       pe->beg_line = lnum;
       pe->end_pos  = curr_pos;
@@ -769,7 +772,7 @@ post_t * instance_t::parse_post(char *		line,
   std::auto_ptr<post_t> post(new post_t);
 
   post->xact    = xact;	// this could be NULL
-  post->pathname = pathname;
+  post->source_file = source_file;
   post->beg_pos  = line_beg_pos;
   post->beg_line = linenum;
 
@@ -956,25 +959,24 @@ post_t * instance_t::parse_post(char *		line,
 
     p = skip_ws(next);
     if (*p) {
-      post->assigned_amount = amount_t();
+      amount_t amt;
 
       beg = p - line;
       ptristream stream(p, len - beg);
 
       if (*p != '(')		// indicates a value expression
-	post->assigned_amount->parse(stream, amount_t::PARSE_NO_MIGRATE);
+	amt.parse(stream, amount_t::PARSE_NO_MIGRATE);
       else
-	parse_amount_expr(session_scope, stream, *post->assigned_amount, post.get(),
+	parse_amount_expr(session_scope, stream, amt, post.get(),
 			  static_cast<uint_least8_t>(expr_t::PARSE_SINGLE) |
 			  static_cast<uint_least8_t>(expr_t::PARSE_NO_MIGRATE));
 
-      if (post->assigned_amount->is_null())
+      if (amt.is_null())
 	throw parse_error(_("An assigned balance must evaluate to a constant value"));
 
       DEBUG("textual.parse", "line " << linenum << ": "
-	    << "POST assign: parsed amt = " << *post->assigned_amount);
+	    << "POST assign: parsed amt = " << amt);
 
-      amount_t&	amt(*post->assigned_amount);
       value_t   account_total(post->account->self_total(false)
 			      .strip_annotations(keep_details_t()));
 
@@ -1102,7 +1104,7 @@ xact_t * instance_t::parse_xact(char *		line,
 
   std::auto_ptr<xact_t> xact(new xact_t);
 
-  xact->pathname = pathname;
+  xact->source_file = source_file;
   xact->beg_pos  = line_beg_pos;
   xact->beg_line = linenum;
 
@@ -1227,7 +1229,7 @@ xact_t * instance_t::parse_xact(char *		line,
   catch (const std::exception& err) {
     if (reveal_context) {
       add_error_context(_("While parsing transaction:"));
-      add_error_context(source_context(xact->pathname,
+      add_error_context(source_context(xact->pathname(),
 				       xact->beg_pos, curr_pos, "> "));
     }
     throw;
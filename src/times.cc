@@ -341,6 +341,20 @@ void date_interval_t::stabilize(const optional<date_t>& date)
   }
 }
 
+namespace {
+  // The number of days in a duration, if that never varies.  Months and
+  // years differ in length, and are not handled here.
+  optional<long> fixed_duration_days(const date_interval_t::duration_t& duration)
+  {
+    if (duration.type() == typeid(gregorian::days))
+      return boost::get<gregorian::days>(duration).days();
+    else if (duration.type() == typeid(gregorian::weeks))
+      return boost::get<gregorian::weeks>(duration).days();
+    else
+      return none;
+  }
+}
+
 bool date_interval_t::find_period(const date_t& date)
 {
   stabilize(date);
@@ -380,6 +394,22 @@ bool date_interval_t::find_period(const date_t& date)
   date_t scan        = *start;
   date_t end_of_scan = *end_of_duration;
 
+  // When periods are a fixed number of days long, skip straight over
+  // every period which ends on or before date, rather than stepping
+  // through them one at a time; the loop below then stops at once.
+  if (skip_duration && duration) {
+    optional<long> skip_days     = fixed_duration_days(*skip_duration);
+    optional<long> duration_days = fixed_duration_days(*duration);
+    if (skip_days && duration_days && *skip_days > 0) {
+      long past = (date - scan).days() - *duration_days;
+      if (past >= 0) {
+	scan	    = scan + gregorian::days(((past / *skip_days) + 1) *
+					     *skip_days);
+	end_of_scan = scan + gregorian::days(*duration_days);
+      }
+    }
+  }
+
   DEBUG("times.interval", "date        = " << date);
   DEBUG("times.interval", "scan        = " << scan);
   DEBUG("times.interval", "end_of_scan = " << end_of_scan);
@@ -54,6 +54,7 @@
 #define TRACING_ON  1
 #define DEBUG_ON    1
 #define TIMERS_ON   1
+#define PROFILE_ON  1		// use --profile-exprs to enable
 #elif defined(NDEBUG)
 #define NO_ASSERTS  1
 #define NO_LOGGING  1
@@ -594,6 +595,115 @@ inline char peek_next_nonws(std::istream& in) {
     *_p = '\0';						\
   }
 
+/**
+ * Objects of type T are carved out of large blocks, and returned to a
+ * free list when released, so that a class which creates and destroys
+ * many instances can reuse them rather than make a trip to the heap for
+ * each one.  A class opts in by forwarding its own operator new and
+ * delete to allocate() and release().  Any request of another size, as
+ * made for a derived class, goes to the heap instead.
+ *
+ * The blocks are obtained with malloc so that they stay out of the
+ * memory tracing done under VERIFY_ON.  They are given back only by
+ * release_all(), which its owner calls once it has destroyed the objects
+ * it allocated (see session_t::close_journal_files).  Nothing is freed
+ * while any object from the blocks is still alive.
+ */
+template <typename T, std::size_t BlockCount = 1024>
+class slab_allocator_t
+{
+  struct free_node_t {
+    free_node_t * next;
+  };
+
+  // The first slot of each block links it to the block obtained before
+  // it, so that release_all can find them all.
+  static free_node_t * blocks;
+  static free_node_t * free_list;
+  static char *	       block;
+  static std::size_t   unused;
+  static std::size_t   live;
+
+public:
+  static void * allocate(std::size_t size) {
+    if (size != sizeof(T))
+      return ::operator new(size);
+
+    ++live;
+
+    if (free_list) {
+      void * ptr = free_list;
+      free_list	 = free_list->next;
+      return ptr;
+    }
+
+    if (unused == 0) {
+      char * fresh = static_cast<char *>
+	(std::malloc(sizeof(T) * (BlockCount + 1)));
+      if (! fresh) {
+	--live;
+	throw std::bad_alloc();
+      }
+      free_node_t * link = reinterpret_cast<free_node_t *>(fresh);
+      link->next = blocks;
+      blocks	 = link;
+
+      block  = fresh + sizeof(T);
+      unused = BlockCount;
+    }
+
+    void * ptr = block;
+    block += sizeof(T);
+    --unused;
+    return ptr;
+  }
+
+  static void release(void * ptr, std::size_t size) {
+    if (! ptr)
+      return;
+
+    if (size != sizeof(T)) {
+      ::operator delete(ptr);
+      return;
+    }
+
+    free_node_t * node = static_cast<free_node_t *>(ptr);
+    node->next = free_list;
+    free_list  = node;
+    --live;
+  }
+
+  // Give every block back to the heap, if no object allocated from them
+  // is still alive.  Returns false, and frees nothing, if one is.
+  static bool release_all() {
+    if (live > 0)
+      return false;
+
+    while (blocks) {
+      free_node_t * next = blocks->next;
+      std::free(blocks);
+      blocks = next;
+    }
+    free_list = NULL;
+    block     = NULL;
+    unused    = 0;
+    return true;
+  }
+};
+
+template <typename T, std::size_t BlockCount>
+typename slab_allocator_t<T, BlockCount>::free_node_t *
+slab_allocator_t<T, BlockCount>::blocks = NULL;
+template <typename T, std::size_t BlockCount>
+typename slab_allocator_t<T, BlockCount>::free_node_t *
+slab_allocator_t<T, BlockCount>::free_list = NULL;
+template <typename T, std::size_t BlockCount>
+char * slab_allocator_t<T, BlockCount>::block = NULL;
+template <typename T, std::size_t BlockCount>
+std::size_t slab_allocator_t<T, BlockCount>::unused = 0;
+template <typename T, std::size_t BlockCount>
+std::size_t slab_allocator_t<T, BlockCount>::live = 0;
+
 extern const string version;
 
 } // namespace ledger
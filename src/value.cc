@@ -42,6 +42,56 @@ namespace ledger {
 intrusive_ptr<value_t::storage_t> value_t::true_value;
 intrusive_ptr<value_t::storage_t> value_t::false_value;
 
+void * value_t::storage_t::operator new(std::size_t size)
+{
+  return slab_allocator_t<storage_t>::allocate(size);
+}
+
+void value_t::storage_t::operator delete(void * ptr, std::size_t size)
+{
+  slab_allocator_t<storage_t>::release(ptr, size);
+}
+
+namespace {
+  // Only a few small sequences are kept, which is all that nested
+  // function calls need at any one time.  A plain array is used so that
+  // nothing here is destroyed before the last value_t is.
+  const std::size_t max_spare_sequences = 64;
+  const std::size_t max_spare_capacity	= 16;
+
+  value_t::sequence_t * spare_sequences[max_spare_sequences];
+  std::size_t		spare_count = 0;
+}
+
+value_t::sequence_t *
+value_t::storage_t::new_sequence(const sequence_t& val)
+{
+  if (spare_count == 0)
+    return new sequence_t(val);
+
+  sequence_t * seq = spare_sequences[--spare_count];
+  seq->assign(val.begin(), val.end());
+  return seq;
+}
+
+void value_t::storage_t::recycle_sequence(sequence_t * seq)
+{
+  // Clearing may release nested sequences, which are recycled first.
+  seq->clear();
+
+  if (spare_count < max_spare_sequences &&
+      seq->capacity() <= max_spare_capacity)
+    spare_sequences[spare_count++] = seq;
+  else
+    checked_delete(seq);
+}
+
+void value_t::storage_t::clear_spare_sequences()
+{
+  while (spare_count > 0)
+    checked_delete(spare_sequences[--spare_count]);
+}
+
 value_t::storage_t& value_t::storage_t::operator=(const value_t::storage_t& rhs)
 {
   type = rhs.type;
@@ -51,7 +101,7 @@ value_t::storage_t& value_t::storage_t::operator=(const value_t::storage_t& rhs)
     data = new balance_t(*boost::get<balance_t *>(rhs.data));
     break;
   case SEQUENCE:
-    data = new sequence_t(*boost::get<sequence_t *>(rhs.data));
+    data = new_sequence(*boost::get<sequence_t *>(rhs.data));
     break;
 
   default:
@@ -77,6 +127,8 @@ void value_t::shutdown()
 {
   true_value  = intrusive_ptr<storage_t>();
   false_value = intrusive_ptr<storage_t>();
+
+  storage_t::clear_spare_sequences();
 }
 
 value_t::operator bool() const
@@ -170,6 +170,26 @@ private:
       destroy();
     }
 
+    /**
+     * Allocation.  Nearly every intermediate result computed while
+     * evaluating a value expression creates and then discards a
+     * storage_t, so released objects are kept on a free list and
+     * handed back out, rather than going to the heap each time.  See
+     * slab_allocator_t in utils.h.
+     */
+    static void * operator new(std::size_t size);
+    static void   operator delete(void * ptr, std::size_t size);
+
+    /**
+     * Sequences are recycled as well, since every function call made
+     * while evaluating an expression builds one to hold its arguments.
+     * A released sequence is cleared but keeps its capacity, so the
+     * next argument list built in it need not allocate either.
+     */
+    static sequence_t * new_sequence(const sequence_t& val);
+    static void		recycle_sequence(sequence_t * seq);
+    static void		clear_spare_sequences();
+
   private:
     /**
      * Assignment and copy operators.  These are called when making a
@@ -215,7 +235,7 @@ private:
 	checked_delete(boost::get<balance_t *>(data));
 	break;
       case SEQUENCE:
-	checked_delete(boost::get<sequence_t *>(data));
+	recycle_sequence(boost::get<sequence_t *>(data));
 	break;
       default:
 	break;
@@ -678,7 +698,7 @@ public:
   }
   void set_sequence(const sequence_t& val) {
     set_type(SEQUENCE);
-    storage->data = new sequence_t(val);
+    storage->data = storage_t::new_sequence(val);
   }
 
   /**
@@ -309,7 +309,9 @@ bool xact_base_t::finalize()
     throw_(balance_error, _("Transaction does not balance"));
   }
 
-  // Add a pointer to each posting to their related accounts
+  // Add a pointer to each posting to their related accounts.  This is
+  // only done once the xact is known to be accepted, so that no account
+  // is left pointing at the postings of an xact which is then deleted.
 
   if (dynamic_cast<xact_t *>(this)) {
     bool all_null  = true;
@@ -321,17 +323,19 @@ bool xact_base_t::finalize()
       } else {
 	some_null = true;
       }
-
-      post->account->add_post(post);
-
-      post->xdata().add_flags(POST_EXT_VISITED);
-      post->account->xdata().add_flags(ACCOUNT_EXT_VISITED);
     }
     if (all_null)
       return false;		// ignore this xact completely
     else if (some_null)
       throw_(balance_error,
 	     _("There cannot be null amounts after balancing a transaction"));
+
+    foreach (post_t * post, posts) {
+      post->account->add_post(post);
+
+      post->xdata().add_flags(POST_EXT_VISITED);
+      post->account->xdata().add_flags(ACCOUNT_EXT_VISITED);
+    }
   }
 
   VERIFY(valid());
@@ -340,7 +344,7 @@ bool xact_base_t::finalize()
 }
 
 xact_t::xact_t(const xact_t& e)
-  : xact_base_t(e), code(e.code), payee(e.payee)
+  : xact_base_t(e), code(e.code), payee(e.payee), sequence(0)
 {
   TRACE_CTOR(xact_t, "copy");
 }
@@ -92,8 +92,9 @@ class xact_t : public xact_base_t
 public:
   optional<string> code;
   string	   payee;
+  std::size_t	   sequence;	// order in which it was added to its journal
 
-  xact_t() {
+  xact_t() : sequence(0) {
     TRACE_CTOR(xact_t, "");
   }
   xact_t(const xact_t& e);
@@ -102,6 +103,13 @@ public:
     TRACE_DTOR(xact_t);
   }
 
+  static void * operator new(std::size_t size) {
+    return slab_allocator_t<xact_t>::allocate(size);
+  }
+  static void operator delete(void * ptr, std::size_t size) {
+    slab_allocator_t<xact_t>::release(ptr, size);
+  }
+
   virtual void add_post(post_t * post);
 
   virtual expr_t::ptr_op_t lookup(const string& name);
@@ -0,0 +1,67 @@
+#include <system.hh>
+
+#include "t_mask.h"
+
+#include "utils.h"
+#include "mask.h"
+
+using namespace ledger;
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(MaskTestCase, "util");
+
+void MaskTestCase::testLiteralDetection()
+{
+  assertTrue(mask_t("food").is_literal);
+  assertTrue(mask_t("Expenses:Food").is_literal);
+  assertTrue(mask_t("^Assets").is_literal);
+  assertTrue(mask_t("Cash$").is_literal);
+  assertTrue(mask_t("^Assets:Cash$").is_literal);
+  assertTrue(mask_t("books|food|^rent").is_literal);
+  assertTrue(mask_t("a\\.b").is_literal);
+  assertTrue(mask_t("").is_literal);
+
+  assertFalse(mask_t("foo.d").is_literal);
+  assertFalse(mask_t("fo+d").is_literal);
+  assertFalse(mask_t("(food)").is_literal);
+  assertFalse(mask_t("[Ff]ood").is_literal);
+  assertFalse(mask_t("\\bfood").is_literal);
+  assertFalse(mask_t("\\<food").is_literal);
+  assertFalse(mask_t("fo^od").is_literal);
+  assertFalse(mask_t("fo$od").is_literal);
+
+  assertFalse(mask_t("food").is_anchored);
+  assertTrue(mask_t("food|^rent").is_anchored);
+}
+
+void MaskTestCase::testAgainstRegex()
+{
+#ifndef NOT_FOR_PYTHON
+  const char * patterns[] = {
+    "", "a", "food", "FOOD", "Expenses:Food", "^expenses", "^Expenses:",
+    "cash$", "^Assets:Cash$", "^$", "^", "$", "books|food", "books|",
+    "|", "^a|b$", "x|^Assets:Cash$|y", "a\\.b", "a\\:b", "a\\|b", "\\^a",
+    "$1.00", "1\\$", "e", "ee", "aab", "#tag", "a b", "Z", "@",
+    "\\<food", "food\\>", "\\`food", "food\\'", NULL
+  };
+
+  const char * subjects[] = {
+    "", "a", "A", "b", "food", "Food", "FOOD", "Expenses:Food",
+    "Expenses:Food:Dining", "expenses", "Assets:Cash", "assets:cash",
+    "Assets:Cash:Wallet", "Liabilities:Assets:Cash", "books", "a.b",
+    "axb", "a:b", "a|b", "^a", "$1.00", "1$", "aaab", "aab", "#tag",
+    "a b", "z", "@", "line\nfood", "food\n", "\nAssets:Cash",
+    "Assets:Cash\r\n", "cash\fcash", "\xc3\xa9t\xc3\xa9", "foodie",
+    "<food", "food>", "`food", "food'", "seafood", NULL
+  };
+
+  for (const char ** pat = patterns; *pat; pat++) {
+    mask_t	 mask(*pat);
+    boost::regex expr(*pat, boost::regex::perl | boost::regex::icase);
+
+    for (const char ** subj = subjects; *subj; subj++)
+      assertEqualMessage(string("/") + *pat + "/ =~ \"" + *subj + "\"",
+			 boost::regex_search(string(*subj), expr),
+			 mask.match(*subj));
+  }
+#endif // NOT_FOR_PYTHON
+}
@@ -0,0 +1,30 @@
+#ifndef _T_MASK_H
+#define _T_MASK_H
+
+#include "UnitTests.h"
+
+class MaskTestCase : public CPPUNIT_NS::TestCase
+{
+  CPPUNIT_TEST_SUITE(MaskTestCase);
+
+  CPPUNIT_TEST(testLiteralDetection);
+  CPPUNIT_TEST(testAgainstRegex);
+
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  MaskTestCase() {}
+  virtual ~MaskTestCase() {}
+
+  //virtual void setUp();
+  //virtual void tearDown();
+
+  void testLiteralDetection();
+  void testAgainstRegex();
+
+private:
+  MaskTestCase(const MaskTestCase &copy);
+  void operator=(const MaskTestCase &copy);
+};
+
+#endif /* _T_MASK_H */
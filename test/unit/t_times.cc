@@ -154,3 +154,37 @@ void DateTimeTestCase::testConstructors()
 #endif // NOT_FOR_PYTHON
 #endif
 }
+
+void DateTimeTestCase::testFindPeriod()
+{
+  date_interval_t weekly;
+  weekly.start	  = date_t(2009, 1, 4);
+  weekly.aligned  = true;
+  weekly.duration = date_interval_t::duration_t(gregorian::weeks(1));
+
+  assertTrue(weekly.find_period(date_t(2009, 1, 6)));
+  assertEqual(date_t(2009, 1, 4), *weekly.start);
+
+  // Many periods ahead of the current one
+  assertTrue(weekly.find_period(date_t(2009, 3, 20)));
+  assertEqual(date_t(2009, 3, 15), *weekly.start);
+  assertEqual(date_t(2009, 3, 22), *weekly.end_of_duration);
+
+  // Before the current period
+  assertFalse(weekly.find_period(date_t(2009, 1, 10)));
+  assertEqual(date_t(2009, 3, 15), *weekly.start);
+
+  // Periods separated by gaps: one week in every two
+  date_interval_t fortnightly;
+  fortnightly.start	    = date_t(2009, 1, 4);
+  fortnightly.aligned	    = true;
+  fortnightly.duration	    = date_interval_t::duration_t(gregorian::weeks(1));
+  fortnightly.skip_duration = date_interval_t::duration_t(gregorian::weeks(2));
+
+  assertTrue(fortnightly.find_period(date_t(2009, 2, 3)));
+  assertEqual(date_t(2009, 2, 1), *fortnightly.start);
+  assertFalse(fortnightly.find_period(date_t(2009, 2, 10)));
+  assertEqual(date_t(2009, 2, 1), *fortnightly.start);
+  assertTrue(fortnightly.find_period(date_t(2009, 2, 15)));
+  assertEqual(date_t(2009, 2, 15), *fortnightly.start);
+}
@@ -8,6 +8,7 @@ class DateTimeTestCase : public CPPUNIT_NS::TestCase
   CPPUNIT_TEST_SUITE(DateTimeTestCase);
 
   CPPUNIT_TEST(testConstructors);
+  CPPUNIT_TEST(testFindPeriod);
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -19,6 +20,7 @@ public:
   //virtual void tearDown();
 
   void testConstructors();
+  void testFindPeriod();
 
 private:
   DateTimeTestCase(const DateTimeTestCase &copy);